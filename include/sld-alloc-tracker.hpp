@@ -0,0 +1,278 @@
+#ifndef SLD_ALLOC_TRACKER_HPP
+#define SLD_ALLOC_TRACKER_HPP
+
+#include <cstdio>
+
+#include "sld.hpp"
+
+// NOTE(SAM): tracking is compiled out unless SLD_ALLOC_TRACKING is set, when it's off
+// the allocators don't carry a tracker pointer and the push paths are unchanged
+#ifndef    SLD_ALLOC_TRACKING
+#   define SLD_ALLOC_TRACKING 0
+#endif
+#ifndef    SLD_ALLOC_TRACKER_SITE_COUNT
+#   define SLD_ALLOC_TRACKER_SITE_COUNT 64
+#endif
+
+// call sites are picked up through defaulted trailing parameters, so the
+// caller's file and line are captured without wrapping every push in a macro
+#if SLD_ALLOC_TRACKING
+#   define SLD_ALLOC_SITE_PARAMS  , const cchar* site_file = __builtin_FILE(), const u32 site_line = __builtin_LINE()
+#   define SLD_ALLOC_SITE_ARGS    , const cchar* site_file, const u32 site_line
+#   define SLD_ALLOC_SITE_FORWARD , site_file, site_line
+#else
+#   define SLD_ALLOC_SITE_PARAMS
+#   define SLD_ALLOC_SITE_ARGS
+#   define SLD_ALLOC_SITE_FORWARD
+#endif
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // ALLOC TRACKER
+    //-------------------------------------------------------------------
+
+    constexpr u32 ALLOC_TRACKER_SITE_COUNT = SLD_ALLOC_TRACKER_SITE_COUNT;
+
+    static_assert(size_is_pow_2(ALLOC_TRACKER_SITE_COUNT), "alloc tracker site count must be a power of 2");
+
+    struct alloc_tracker_t;
+    struct alloc_tracker_stats_t;
+    struct alloc_site_t;
+
+    SLD_API_INLINE void alloc_tracker_init           (alloc_tracker_t*       tracker, const cchar* name);
+    SLD_API_INLINE void alloc_tracker_reset          (alloc_tracker_t*       tracker);
+    SLD_API_INLINE void alloc_tracker_record_push    (alloc_tracker_t*       tracker, const u64 size, const u64 position, const bool is_pushed, const cchar* site_file, const u32 site_line);
+    SLD_API_INLINE void alloc_tracker_frame_end      (alloc_tracker_t*       tracker);
+    SLD_API_INLINE void alloc_tracker_get_stats      (const alloc_tracker_t* tracker, alloc_tracker_stats_t& stats);
+    SLD_API_INLINE u32  alloc_tracker_get_site_count (const alloc_tracker_t* tracker);
+    SLD_API_INLINE bool alloc_tracker_get_site       (const alloc_tracker_t* tracker, const u32 index, alloc_site_t& site);
+    SLD_API_INLINE u32  alloc_tracker_dump           (const alloc_tracker_t* tracker, cchar* buffer, const u32 buffer_size);
+
+    // NOTE(SAM): sites are keyed by the file pointer and line, __builtin_FILE
+    // gives the same literal for the same file so the pointer is enough
+    struct alloc_site_t {
+        const cchar* file;
+        u32          line;
+        u32          push_count;
+        u64          bytes;
+    };
+
+    struct alloc_tracker_stats_t {
+        u64 high_water;
+        u64 bytes_total;
+        u64 bytes_frame;
+        u64 bytes_frame_last;
+        u64 bytes_frame_peak;
+        u64 push_count;
+        u64 push_failed_count;
+        u64 frame_count;
+        u32 site_count;
+        u32 site_dropped_count;
+    };
+
+    // NOTE(SAM): a tracker isn't thread safe, it belongs to one allocator
+    // (or a group of allocators that are used from the same thread)
+    struct alloc_tracker_t {
+        const cchar*          name;
+        alloc_tracker_stats_t stats;
+        alloc_site_t          sites[ALLOC_TRACKER_SITE_COUNT];
+    };
+
+    //-------------------------------------------------------------------
+    // INLINE METHODS
+    //-------------------------------------------------------------------
+
+    SLD_API_INLINE void
+    alloc_tracker_init(
+        alloc_tracker_t* tracker,
+        const cchar*     name) {
+
+        assert(tracker != NULL);
+
+        tracker->name = name;
+        alloc_tracker_reset(tracker);
+    }
+
+    SLD_API_INLINE void
+    alloc_tracker_reset(
+        alloc_tracker_t* tracker) {
+
+        assert(tracker != NULL);
+
+        memset(&tracker->stats, 0, sizeof(tracker->stats));
+        memset(tracker->sites,  0, sizeof(tracker->sites));
+    }
+
+    SLD_API_INLINE void
+    alloc_tracker_record_push(
+        alloc_tracker_t* tracker,
+        const u64        size,
+        const u64        position,
+        const bool       is_pushed,
+        const cchar*     site_file,
+        const u32        site_line) {
+
+        assert(tracker != NULL);
+
+        alloc_tracker_stats_t& stats = tracker->stats;
+        if (!is_pushed) {
+            ++stats.push_failed_count;
+            return;
+        }
+
+        ++stats.push_count;
+        stats.bytes_total += size;
+        stats.bytes_frame += size;
+        if (position > stats.high_water) {
+            stats.high_water = position;
+        }
+
+        // open addressing on the file and line, sites are never removed so a
+        // full table just counts what it couldn't place
+        const u32 mask  = (ALLOC_TRACKER_SITE_COUNT - 1);
+        const u32 key   = ((u32)(addr)site_file ^ site_line);
+        u32       index = ((key * 0x9E3779B1) >> 16) & mask;
+        for (
+            u32 probe = 0;
+            probe < ALLOC_TRACKER_SITE_COUNT;
+            ++probe) {
+
+            alloc_site_t& site = tracker->sites[index];
+            if (site.file == NULL) {
+                site.file = site_file;
+                site.line = site_line;
+                ++stats.site_count;
+            }
+            if (site.file == site_file && site.line == site_line) {
+                ++site.push_count;
+                site.bytes += size;
+                return;
+            }
+            index = (index + 1) & mask;
+        }
+        ++stats.site_dropped_count;
+    }
+
+    SLD_API_INLINE void
+    alloc_tracker_frame_end(
+        alloc_tracker_t* tracker) {
+
+        assert(tracker != NULL);
+
+        alloc_tracker_stats_t& stats = tracker->stats;
+        if (stats.bytes_frame > stats.bytes_frame_peak) {
+            stats.bytes_frame_peak = stats.bytes_frame;
+        }
+        stats.bytes_frame_last = stats.bytes_frame;
+        stats.bytes_frame      = 0;
+        ++stats.frame_count;
+    }
+
+    SLD_API_INLINE void
+    alloc_tracker_get_stats(
+        const alloc_tracker_t* tracker,
+        alloc_tracker_stats_t& stats) {
+
+        assert(tracker != NULL);
+        stats = tracker->stats;
+    }
+
+    SLD_API_INLINE u32
+    alloc_tracker_get_site_count(
+        const alloc_tracker_t* tracker) {
+
+        assert(tracker != NULL);
+        return(tracker->stats.site_count);
+    }
+
+    SLD_API_INLINE bool
+    alloc_tracker_get_site(
+        const alloc_tracker_t* tracker,
+        const u32              index,
+        alloc_site_t&          site) {
+
+        // index is the nth used site, not the slot
+        assert(tracker != NULL);
+
+        u32 site_index = 0;
+        for (
+            u32 slot = 0;
+            slot < ALLOC_TRACKER_SITE_COUNT;
+            ++slot) {
+
+            const alloc_site_t& slot_site = tracker->sites[slot];
+            if (slot_site.file == NULL) continue;
+            if (site_index == index) {
+                site = slot_site;
+                return(true);
+            }
+            ++site_index;
+        }
+        return(false);
+    }
+
+    SLD_API_INLINE u32
+    alloc_tracker_dump(
+        const alloc_tracker_t* tracker,
+        cchar*                 buffer,
+        const u32              buffer_size) {
+
+        assert(tracker != NULL && buffer != NULL && buffer_size != 0);
+
+        // returns the length written, the output is truncated to fit the buffer
+        const alloc_tracker_stats_t& stats  = tracker->stats;
+        u32                          length = 0;
+
+        const auto append = [&](const s32 count) {
+            if (count > 0) {
+                length += (u32)count;
+                if (length >= buffer_size) length = (buffer_size - 1);
+            }
+        };
+
+        append(snprintf(
+            buffer, buffer_size,
+            "[%s]\n"
+            "  high water:   %llu\n"
+            "  bytes total:  %llu\n"
+            "  frame last:   %llu\n"
+            "  frame peak:   %llu\n"
+            "  frames:       %llu\n"
+            "  pushes:       %llu\n"
+            "  failed:       %llu\n"
+            "  sites:        %u (%u dropped)\n",
+            tracker->name ? tracker->name : "alloc",
+            (unsigned long long)stats.high_water,
+            (unsigned long long)stats.bytes_total,
+            (unsigned long long)stats.bytes_frame_last,
+            (unsigned long long)stats.bytes_frame_peak,
+            (unsigned long long)stats.frame_count,
+            (unsigned long long)stats.push_count,
+            (unsigned long long)stats.push_failed_count,
+            stats.site_count,
+            stats.site_dropped_count
+        ));
+
+        for (
+            u32 slot = 0;
+            slot < ALLOC_TRACKER_SITE_COUNT;
+            ++slot) {
+
+            const alloc_site_t& site = tracker->sites[slot];
+            if (site.file == NULL) continue;
+
+            append(snprintf(
+                &buffer[length], (buffer_size - length),
+                "  %s(%u): %u pushes, %llu bytes\n",
+                site.file,
+                site.line,
+                site.push_count,
+                (unsigned long long)site.bytes
+            ));
+        }
+        return(length);
+    }
+};
+
+#endif //SLD_ALLOC_TRACKER_HPP
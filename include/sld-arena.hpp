@@ -2,9 +2,19 @@
 #define SLD_ARENA_HPP
 
 #include "sld.hpp"
+#include "sld-os-memory.hpp"
+#include "sld-alloc-tracker.hpp"
 
 #define SLD_API_INLINE_ARENA                                          inline auto arena::
 #define SLD_API_INLINE_ARENA_TEMPLATE  template<typename struct_type> inline auto arena::
+#define SLD_API_INLINE_ARENA_SCOPE                                    inline arena_scope::
+
+#ifndef    SLD_ARENA_SCRATCH_COUNT
+#   define SLD_ARENA_SCRATCH_COUNT 2
+#endif
+#ifndef    SLD_ARENA_SCRATCH_SIZE
+#   define SLD_ARENA_SCRATCH_SIZE  size_gigabytes(1)
+#endif
 
 namespace sld {
 
@@ -12,6 +22,28 @@ namespace sld {
     // ARENA API
     //-------------------------------------------------------------------
 
+    // NOTE(SAM): reserved arenas commit in chunks of at least this size
+    // so small pushes don't turn into a syscall each
+    constexpr u64 ARENA_COMMIT_GRANULARITY = size_kilobytes(64);
+
+    // NOTE(SAM): scratch arenas are per thread, we need at least two so
+    // a function can take scratch memory that doesn't alias the caller's arena
+    constexpr u32 ARENA_SCRATCH_COUNT              = SLD_ARENA_SCRATCH_COUNT;
+    constexpr u64 ARENA_SCRATCH_SIZE               = SLD_ARENA_SCRATCH_SIZE;
+    constexpr u64 ARENA_SCRATCH_DECOMMIT_THRESHOLD = size_megabytes(1);
+
+    static_assert(ARENA_SCRATCH_COUNT >= 2, "scratch arenas need at least two per thread");
+
+    struct arena;
+    struct arena_temp;
+    struct arena_scope;
+
+    enum arena_flag_e : u32 {
+        arena_flag_e_none        = 0,
+        arena_flag_e_reserved    = bit_value(0),
+        arena_flag_e_large_pages = bit_value(1)
+    };
+
     struct arena {
 
         // members
@@ -19,21 +51,76 @@ namespace sld {
         u64  size;
         u64  position;
         u64  save;
+        u64  committed;
+        u64  decommit_threshold;
+        u32  flags;
+    #if SLD_ALLOC_TRACKING
+        alloc_tracker_t* tracker; // optional, set after init
+    #endif
 
         // methods
         inline void  init                (const void* memory, const u64 size);
+        inline bool  init_reserved       (const u64 size_reserved, const u64 decommit_threshold = 0, const bool use_large_pages = false);
+        inline void  release             (void);
         inline bool  is_valid            (void);
+        inline bool  is_reserved         (void);
+        inline bool  is_large_pages      (void);
         inline void  assert_valid        (void);
         inline void  save_position       (void);
         inline void  roll_back           (void);
         inline void  reset               (void);
         inline u64   get_space_remaining (void);
-        inline byte* push_bytes          (const u64 size, const u64 alignment = 0);
+        inline byte* push_bytes          (const u64 size, const u64 alignment = 0 SLD_ALLOC_SITE_PARAMS);
+        inline auto  temp_begin          (void) -> arena_temp;
+        inline void  temp_end            (const arena_temp& temp);
 
         // template methods
-        template<typename struct_type> inline struct_type* push_struct (const u32 count = 1);
+        template<typename struct_type> inline struct_type* push_struct (const u32 count = 1 SLD_ALLOC_SITE_PARAMS);
+
+        // internal
+        inline u64   commit_alignment    (void);
+        inline bool  commit_to           (const u64 position);
+        inline void  decommit_to         (const u64 position);
+    };
+
+    //-------------------------------------------------------------------
+    // ARENA TEMP
+    //-------------------------------------------------------------------
+
+    // NOTE(SAM): unlike save_position/roll_back these nest, each temp
+    // remembers its own position and they have to end in reverse order
+    struct arena_temp {
+        arena* source;
+        u64    position;
+    };
+
+    struct arena_scope {
+
+        // members
+        arena_temp temp;
+
+        // constructors
+        inline  arena_scope (arena& source);
+        inline  arena_scope (const arena_temp& temp);
+        inline ~arena_scope (void);
+
+        arena_scope            (const arena_scope&) = delete;
+        arena_scope& operator= (const arena_scope&) = delete;
+
+        // methods
+        inline arena* get (void) const;
     };
 
+    //-------------------------------------------------------------------
+    // ARENA SCRATCH
+    //-------------------------------------------------------------------
+
+    SLD_API_INLINE arena_temp arena_scratch_begin   (arena* const* conflicts = NULL, const u32 conflict_count = 0);
+    SLD_API_INLINE void       arena_scratch_end     (const arena_temp& temp);
+    SLD_API_INLINE void       arena_scratch_release (void);
+
+    inline thread_local arena _arena_scratch[ARENA_SCRATCH_COUNT];
+
     //-------------------------------------------------------------------
     // ARENA INLINE METHODS
     //-------------------------------------------------------------------
@@ -44,11 +131,73 @@ namespace sld {
         const void* memory,
         const u64   size) -> void {
 
-        assert(memory != NULL && size != NULL);
+        assert(memory != NULL && size != 0);
+
+        this->start              = (addr)memory;
+        this->size               = size;
+        this->position           = 0;
+        this->save               = 0;
+        this->committed          = size;
+        this->decommit_threshold = 0;
+        this->flags              = arena_flag_e_none;
+    #if SLD_ALLOC_TRACKING
+        this->tracker            = NULL;
+    #endif
+    }
 
-        this->start = (addr)memory;
-        this->size  = size;
+    SLD_API_INLINE_ARENA
+    init_reserved(
+        const u64  size_reserved,
+        const u64  decommit_threshold,
+        const bool use_large_pages) -> bool {
+
+        assert(size_reserved != 0);
+
+        // reserve the address range, pages are committed as the position advances
+        // large pages are a request, we fall back to regular pages if the os says no
+        u64   size_aligned = 0;
+        void* memory       = NULL;
+        u32   flags        = arena_flag_e_reserved;
+        if (use_large_pages) {
+            size_aligned = os_memory_align_to_large_page (size_reserved);
+            memory       = os_memory_reserve_large       (NULL, size_aligned);
+            if (memory) flags |= arena_flag_e_large_pages;
+        }
+        if (!memory) {
+            size_aligned = os_memory_align_to_granularity (size_reserved);
+            memory       = os_memory_reserve              (NULL, size_aligned);
+        }
+        if (!memory) return(false);
+
+        this->start              = (addr)memory;
+        this->size               = size_aligned;
+        this->position           = 0;
+        this->save               = 0;
+        this->committed          = 0;
+        this->decommit_threshold = decommit_threshold;
+        this->flags              = flags;
+    #if SLD_ALLOC_TRACKING
+        this->tracker            = NULL;
+    #endif
+        return(true);
+    }
+
+    SLD_API_INLINE_ARENA
+    release(
+        void) -> void {
+
+        this->assert_valid();
+        assert(this->is_reserved());
+
+        (void)os_memory_release((void*)this->start, this->size);
 
+        this->start              = 0;
+        this->size               = 0;
+        this->position           = 0;
+        this->save               = 0;
+        this->committed          = 0;
+        this->decommit_threshold = 0;
+        this->flags              = arena_flag_e_none;
     }
 
     SLD_API_INLINE_ARENA
@@ -56,14 +205,29 @@ namespace sld {
         void) -> bool {
 
         const bool is_valid = (
-            this->start    != NULL      &&
-            this->size     != 0         &&
-            this->position < this->size &&
-            this->save     <= this->position
+            this->start     != 0               &&
+            this->size      != 0               &&
+            this->position  <= this->size      &&
+            this->save      <= this->position  &&
+            this->committed <= this->size
         );
         return(is_valid);
     }
 
+    SLD_API_INLINE_ARENA
+    is_reserved(
+        void) -> bool {
+
+        return((this->flags & arena_flag_e_reserved) != 0);
+    }
+
+    SLD_API_INLINE_ARENA
+    is_large_pages(
+        void) -> bool {
+
+        return((this->flags & arena_flag_e_large_pages) != 0);
+    }
+
     SLD_API_INLINE_ARENA
     assert_valid(
         void) -> void {
@@ -85,6 +249,7 @@ namespace sld {
 
         this->assert_valid();
         this->position = this->save;
+        this->decommit_to(this->position);
     }
 
     SLD_API_INLINE_ARENA
@@ -94,6 +259,7 @@ namespace sld {
         this->assert_valid();
         this->position = 0;
         this->save     = 0;
+        this->decommit_to(this->position);
     }
 
     SLD_API_INLINE_ARENA
@@ -108,34 +274,239 @@ namespace sld {
     SLD_API_INLINE_ARENA
     push_bytes(
         const u64 size,
-        const u64 alignment) -> byte* {
+        const u64 alignment
+        SLD_ALLOC_SITE_ARGS) -> byte* {
 
-        assert(this->is_valid() && size != 0);
+        assert(
+            this->is_valid() &&
+            size != 0        &&
+            (alignment == 0 || size_is_pow_2(alignment))
+        );
 
-        const u64 size_aligned = size_is_pow_2(alignment)
-            ? size_align_pow_2 (size, alignment)
-            : size_align       (size, alignment);
+        // align the address, not just the size. the start of a fixed arena
+        // can be anything and earlier pushes can leave the position anywhere
+        const addr address_current = (this->start + this->position);
+        const addr address_aligned = (addr)size_align_pow_2(address_current, alignment);
+        const u64  size_aligned    = (address_aligned - address_current) + size;
 
         const u64  new_position = (this->position + size_aligned);
-        const bool can_push     = (new_position <= this->size);
+        const bool can_push     = (new_position <= this->size) && (
+            (new_position <= this->committed) ||
+            this->commit_to(new_position)
+        );
         
         byte* bytes = NULL;
         if (can_push) {
 
-            bytes          = (byte*)(this->start + this->position);
+            bytes          = (byte*)address_aligned;
             this->position = new_position;
         }
+
+    #if SLD_ALLOC_TRACKING
+        if (this->tracker) {
+            alloc_tracker_record_push(this->tracker, size_aligned, new_position, can_push, site_file, site_line);
+        }
+    #endif
         return(bytes);
     }
 
+    SLD_API_INLINE_ARENA
+    temp_begin(
+        void) -> arena_temp {
+
+        this->assert_valid();
+
+        arena_temp temp;
+        temp.source   = this;
+        temp.position = this->position;
+        return(temp);
+    }
+
+    SLD_API_INLINE_ARENA
+    temp_end(
+        const arena_temp& temp) -> void {
+
+        // temps have to end in the reverse order they began
+        assert(
+            this->is_valid()             &&
+            temp.source   == this        &&
+            temp.position <= this->position
+        );
+
+        this->position = temp.position;
+        if (this->save > this->position) {
+            this->save = this->position;
+        }
+        this->decommit_to(this->position);
+    }
+
     SLD_API_INLINE_ARENA_TEMPLATE 
     push_struct(
-        const u32 count) -> struct_type* {
+        const u32 count
+        SLD_ALLOC_SITE_ARGS) -> struct_type* {
 
         const u64    size    = count * sizeof(struct_type);
-        struct_type* structs = this->push_bytes(size);
+        struct_type* structs = (struct_type*)this->push_bytes(size, 0 SLD_ALLOC_SITE_FORWARD);
         return(structs); 
     }
+
+    SLD_API_INLINE_ARENA
+    commit_alignment(
+        void) -> u64 {
+
+        // commits on large page arenas cover whole large pages so the os can back them with one
+        const u64 alignment = this->is_large_pages()
+            ? os_memory_get_large_page_size ()
+            : os_memory_align_to_page       (1);
+        return(alignment);
+    }
+
+    SLD_API_INLINE_ARENA
+    commit_to(
+        const u64 position) -> bool {
+
+        // fixed arenas are fully committed up front
+        if (!this->is_reserved()) return(position <= this->committed);
+
+        // grow by at least the commit granularity, clamped to the reservation
+        u64 commit_end = (position > (this->committed + ARENA_COMMIT_GRANULARITY))
+            ? position
+            : (this->committed + ARENA_COMMIT_GRANULARITY);
+        commit_end = size_align_pow_2(commit_end, this->commit_alignment());
+        if (commit_end > this->size) {
+            commit_end = this->size;
+        }
+        if (commit_end < position) return(false);
+
+        void*      commit_start = (void*)(this->start + this->committed);
+        const u64  commit_size  = (commit_end - this->committed);
+        const bool is_committed = (os_memory_commit(commit_start, commit_size) != NULL);
+        if (is_committed) {
+            this->committed = commit_end;
+        }
+        return(is_committed);
+    }
+
+    SLD_API_INLINE_ARENA
+    decommit_to(
+        const u64 position) -> void {
+
+        // a threshold of zero keeps everything we've committed
+        const bool can_decommit = this->is_reserved() && (this->decommit_threshold != 0);
+        if (!can_decommit) return;
+
+        // keep the threshold worth of pages above the position, release the rest
+        const u64 keep_end = size_align_pow_2(position + this->decommit_threshold, this->commit_alignment());
+        if (keep_end >= this->committed) return;
+
+        void*      decommit_start  = (void*)(this->start + keep_end);
+        const u64  decommit_size   = (this->committed - keep_end);
+        const bool is_decommitted  = os_memory_decommit(decommit_start, decommit_size);
+        if (is_decommitted) {
+            this->committed = keep_end;
+        }
+    }
+
+    //-------------------------------------------------------------------
+    // ARENA SCOPE INLINE METHODS
+    //-------------------------------------------------------------------
+
+    SLD_API_INLINE_ARENA_SCOPE
+    arena_scope(
+        arena& source) {
+
+        this->temp = source.temp_begin();
+    }
+
+    SLD_API_INLINE_ARENA_SCOPE
+    arena_scope(
+        const arena_temp& temp) {
+
+        this->temp = temp;
+    }
+
+    SLD_API_INLINE_ARENA_SCOPE
+    ~arena_scope(
+        void) {
+
+        this->temp.source->temp_end(this->temp);
+    }
+
+    inline auto arena_scope::
+    get(
+        void) const -> arena* {
+
+        return(this->temp.source);
+    }
+
+    //-------------------------------------------------------------------
+    // ARENA SCRATCH INLINE METHODS
+    //-------------------------------------------------------------------
+
+    SLD_API_INLINE arena_temp
+    arena_scratch_begin(
+        arena* const* conflicts,
+        const u32     conflict_count) {
+
+        assert(conflicts != NULL || conflict_count == 0);
+
+        // pick the first scratch arena that isn't one the caller is already using
+        arena* scratch = NULL;
+        for (
+            u32 scratch_index = 0;
+            scratch_index < ARENA_SCRATCH_COUNT && scratch == NULL;
+            ++scratch_index) {
+
+            arena* candidate   = &_arena_scratch[scratch_index];
+            bool   is_conflict = false;
+            for (
+                u32 conflict_index = 0;
+                conflict_index < conflict_count && !is_conflict;
+                ++conflict_index) {
+
+                is_conflict = (conflicts[conflict_index] == candidate);
+            }
+            if (!is_conflict) scratch = candidate;
+        }
+        assert(scratch != NULL);
+
+        // scratch arenas are reserved the first time a thread asks for one
+        if (scratch->start == 0) {
+            const bool is_reserved = scratch->init_reserved(
+                ARENA_SCRATCH_SIZE,
+                ARENA_SCRATCH_DECOMMIT_THRESHOLD
+            );
+            assert(is_reserved);
+        }
+
+        const arena_temp temp = scratch->temp_begin();
+        return(temp);
+    }
+
+    SLD_API_INLINE void
+    arena_scratch_end(
+        const arena_temp& temp) {
+
+        assert(temp.source != NULL);
+        temp.source->temp_end(temp);
+    }
+
+    SLD_API_INLINE void
+    arena_scratch_release(
+        void) {
+
+        // call before a thread exits, the reservations aren't freed otherwise
+        for (
+            u32 scratch_index = 0;
+            scratch_index < ARENA_SCRATCH_COUNT;
+            ++scratch_index) {
+
+            arena& scratch = _arena_scratch[scratch_index];
+            if (scratch.start != 0) {
+                scratch.release();
+            }
+        }
+    }
 };
 
 #endif //SLD_ARENA_HPP
\ No newline at end of file
@@ -1,7 +1,12 @@
 #ifndef SLD_ARRAY_LIST_HPP
 #define SLD_ARRAY_LIST_HPP
 
+#include <type_traits>
+
 #include "sld.hpp"
+#include "sld-arena.hpp"
+#include "sld-heap.hpp"
+#include "sld-simd.hpp"
 
 #define SLD_API_INLINE_ARRAY_LIST template<typename t> inline auto array_list<t>::
 
@@ -13,7 +18,13 @@ namespace sld {
 
     constexpr u32 ARRAY_LIST_INVALID_INDEX = 0xFFFFFFFF;
 
-    template<typename t> 
+    static_assert(ARRAY_LIST_INVALID_INDEX == SIMD_SEARCH_INVALID_INDEX, "index_of returns the simd search result as is");
+
+    // NOTE(SAM): a list made with init is fixed, a list made with init_arena or
+    // init_heap grows when it's full. growing doubles the capacity, an arena
+    // list extends in place if it's still the arena's last allocation, otherwise
+    // the elements are copied to a new array (the old one stays in the arena)
+    template<typename t>
     struct array_list {
 
         // type alias
@@ -23,35 +34,49 @@ namespace sld {
         element* array;
         u32      capacity;
         u32      count;
+        arena*   source_arena;
+        heap_t*  source_heap;
 
         // methods
         inline void     init         (element* data, const u64 capacity);
+        inline bool     init_arena   (arena*   arena, const u32 capacity);
+        inline bool     init_heap    (heap_t*  heap,  const u32 capacity);
+        inline void     release      (void);
         inline bool     is_valid     (void) const;
         inline bool     is_empty     (void) const;
         inline bool     is_full      (void) const;
+        inline bool     is_growable  (void) const;
         inline void     assert_valid (void) const;
         inline element& first        (void) const;
         inline element& last         (void) const;
         inline void     reset        (void);
+        inline bool     reserve      (const u32 capacity);
         inline bool     add          (const element* elmnt);
         inline bool     add          (const element& elmnt);
-        inline bool     insert_at    (const element* elmnt, const u32 index);
-        inline bool     insert_at    (const element& elmnt, const u32 index);
+        inline bool     add_range    (const element* elmnts, const u32 count);
+        inline bool     insert_at    (const element* elmnt,  const u32 index);
+        inline bool     insert_at    (const element& elmnt,  const u32 index);
+        inline bool     insert_range (const element* elmnts, const u32 count, const u32 index);
         inline void     remove       (const element* elmnt);
         inline void     remove       (const element& elmnt);
         inline void     remove_at    (const u32 index);
+        inline void     remove_range (const u32 index, const u32 count);
+        inline void     remove_swap  (const u32 index);
         inline u32      index_of     (const element* elmnt) const;
         inline u32      index_of     (const element& elmnt) const;
 
         // operators
         inline element&       operator[] (u32 index);
         inline const element& operator[] (u32 index) const;
+
+        // internal
+        inline bool     grow         (const u32 count_required);
     };
 
     //-------------------------------------------------------------------
     // INLINE METHODS
     //-------------------------------------------------------------------
-    
+
     SLD_API_INLINE_ARRAY_LIST
     init(
         element*  array,
@@ -62,9 +87,77 @@ namespace sld {
             capacity != 0
         );
 
-        this->array    = array;
-        this->capacity = capacity;
-        this->count    = 0;
+        this->array        = array;
+        this->capacity     = capacity;
+        this->count        = 0;
+        this->source_arena = NULL;
+        this->source_heap  = NULL;
+    }
+
+    SLD_API_INLINE_ARRAY_LIST
+    init_arena(
+        arena*    arena,
+        const u32 capacity) -> bool {
+
+        assert(
+            arena    != NULL &&
+            capacity != 0
+        );
+
+        const u64 size  = ((u64)capacity * sizeof(element));
+        element*  array = (element*)arena->push_bytes(size, alignof(element));
+        if (!array) return(false);
+
+        this->array        = array;
+        this->capacity     = capacity;
+        this->count        = 0;
+        this->source_arena = arena;
+        this->source_heap  = NULL;
+        return(true);
+    }
+
+    SLD_API_INLINE_ARRAY_LIST
+    init_heap(
+        heap_t*   heap,
+        const u32 capacity) -> bool {
+
+        // the heap only aligns its blocks to HEAP_ALIGN_SIZE, wider elements need an arena list
+        static_assert(alignof(element) <= HEAP_ALIGN_SIZE, "heap lists can't hold elements aligned past the heap alignment");
+
+        assert(
+            heap     != NULL &&
+            capacity != 0
+        );
+
+        const u64    size = ((u64)capacity * sizeof(element));
+        heap_node_t* node = (size <= 0xFFFFFFFF) ? heap_insert(heap, (u32)size) : NULL;
+        if (!node) return(false);
+
+        this->array        = (element*)heap_node_get_data(node);
+        this->capacity     = capacity;
+        this->count        = 0;
+        this->source_arena = NULL;
+        this->source_heap  = heap;
+        return(true);
+    }
+
+    SLD_API_INLINE_ARRAY_LIST
+    release(
+        void) -> void {
+
+        // arena lists go away with the arena, only heap lists give their array back
+        this->assert_valid();
+
+        if (this->source_heap) {
+            heap_node_t* node = heap_node_from_data(this->array);
+            (void)heap_remove(this->source_heap, node);
+        }
+
+        this->array        = NULL;
+        this->capacity     = 0;
+        this->count        = 0;
+        this->source_arena = NULL;
+        this->source_heap  = NULL;
     }
 
     SLD_API_INLINE_ARRAY_LIST
@@ -94,10 +187,17 @@ namespace sld {
         return(this->count == this->capacity);
     }
 
+    SLD_API_INLINE_ARRAY_LIST
+    is_growable(
+        void) const -> bool {
+
+        return(this->source_arena != NULL || this->source_heap != NULL);
+    }
+
     SLD_API_INLINE_ARRAY_LIST
     assert_valid(
         void) const -> void {
-        
+
         assert(this->is_valid());
     }
 
@@ -113,10 +213,9 @@ namespace sld {
     first(
         void) const -> element& {
 
-        element& elmnt = (!this->is_empty())
-            ? this->array[0]
-            : NULL;
+        assert(!this->is_empty());
 
+        element& elmnt = this->array[0];
         return(elmnt);
     }
 
@@ -124,95 +223,83 @@ namespace sld {
     last(
         void) const -> element& {
 
-        const u32 index = (this->count - 1);
+        assert(!this->is_empty());
 
-        element& elmnt = (!this->is_empty())
-            ? this->array[index]
-            : NULL;
-        
+        const u32 index = (this->count - 1);
+        element&  elmnt = this->array[index];
         return(elmnt);
     }
 
+    SLD_API_INLINE_ARRAY_LIST
+    reserve(
+        const u32 capacity) -> bool {
+
+        this->assert_valid();
+
+        const bool can_reserve = (capacity <= this->capacity) || this->grow(capacity);
+        return(can_reserve);
+    }
+
     SLD_API_INLINE_ARRAY_LIST
     add(
-        const element* element) -> bool {
+        const element* elmnt) -> bool {
 
-        assert(
-            this->is_valid() &&
-            element != NULL
-        );
+        assert(elmnt != NULL);
 
-        const bool can_add = !this->is_full(); 
-        if (can_add) {
-            const u32 index = this->count;
-
-            auto      dst  = (void*)&this->array[index];
-            auto      src  = (void*)element;
-            const u32 size = sizeof(element);
-            memccpy(dst,src, size);
-            
-            ++this->count;
-        } 
+        const bool can_add = this->add_range(elmnt, 1);
         return(can_add);
     }
 
     SLD_API_INLINE_ARRAY_LIST
     add(
-        const element& element) -> bool {
+        const element& elmnt) -> bool {
 
-        this->assert_valid();
-
-        const bool can_add = !this->is_full(); 
-        if (can_add) {
-            const u32 index = this->count;
-
-            auto      dst  = (void*)&this->array[index];
-            auto      src  = (void*)&element;
-            const u32 size = sizeof(element);
-            memcpy(dst,src, size);
-            
-            ++this->count;
-        } 
+        const bool can_add = this->add_range(&elmnt, 1);
         return(can_add);
     }
 
     SLD_API_INLINE_ARRAY_LIST
-    insert_at(
-        const element* elmnt,
-        const u32      index) -> bool {
+    add_range(
+        const element* elmnts,
+        const u32      count) -> bool {
 
         assert(
             this->is_valid() &&
-            !this->is_empty() &&
-            elmnt != NULL  &&
-            index   < this->count &&
+            elmnts != NULL
         );
 
-        const u32  element_size = sizeof(element); 
-        const bool can_add      = !this->is_full();
+        // elmnts can point into this list, growing can move it (and a heap list
+        // frees the old array) so hold on to it as an index until after
+        const bool is_aliased   = ((addr)elmnts >= (addr)this->array && (addr)elmnts < (addr)(this->array + this->capacity));
+        const u32  index_source = is_aliased ? (u32)(elmnts - this->array) : 0;
+
+        const u32  count_required = (this->count + count);
+        const bool can_add        = (count_required <= this->capacity) || this->grow(count_required);
         if (can_add) {
-            
-            if (index > 0) {
-                void*       move_dst  = (void*)&this->array[index + 1];
-                const void* move_src  = (void*)&this->array[index];
-                const u32   move_size = element_size * (this->count - index);
-                memmove(
-                    move_dst
-                    move_src
-                    move_size
-                );
-            } 
 
-            void*       copy_dst = (void*)&this->array[index];
-            const void* copy_src = (void*)elmnt;
-            memccpy(
+            const element* source = is_aliased ? &this->array[index_source] : elmnts;
+
+            void*       copy_dst  = (void*)&this->array[this->count];
+            const void* copy_src  = (void*)source;
+            const u64   copy_size = ((u64)count * sizeof(element));
+            memcpy(
                 copy_dst,
                 copy_src,
-                element_size
+                copy_size
             );
-            ++this->count;
+            this->count = count_required;
         }
+        return(can_add);
+    }
 
+    SLD_API_INLINE_ARRAY_LIST
+    insert_at(
+        const element* elmnt,
+        const u32      index) -> bool {
+
+        assert(elmnt != NULL);
+
+        const bool can_add = this->insert_range(elmnt, 1, index);
         return(can_add);
     }
 
@@ -221,35 +308,66 @@ namespace sld {
         const element& elmnt,
         const u32      index) -> bool {
 
+        const bool can_add = this->insert_range(&elmnt, 1, index);
+        return(can_add);
+    }
+
+    SLD_API_INLINE_ARRAY_LIST
+    insert_range(
+        const element* elmnts,
+        const u32      count,
+        const u32      index) -> bool {
+
         assert(
-            this->is_valid()  &&
-            !this->is_empty() &&
-            index < this->count
+            this->is_valid() &&
+            elmnts != NULL   &&
+            index  <= this->count
         );
 
-        const u32  element_size = sizeof(element); 
-        const bool can_add      = !this->is_full();
+        // same as add_range, elmnts can point into this list so it's held as an index
+        const bool is_aliased   = ((addr)elmnts >= (addr)this->array && (addr)elmnts < (addr)(this->array + this->capacity));
+        const u32  index_source = is_aliased ? (u32)(elmnts - this->array) : 0;
+
+        const u32  count_required = (this->count + count);
+        const bool can_add        = (count_required <= this->capacity) || this->grow(count_required);
         if (can_add) {
-            
-            if (index > 0) {
-                void*       move_dst  = (void*)&this->array[index + 1];
+
+            // shift the tail up once for the whole range
+            if (index < this->count) {
+                void*       move_dst  = (void*)&this->array[index + count];
                 const void* move_src  = (void*)&this->array[index];
-                const u32   move_size = element_size * (this->count - index);
+                const u64   move_size = ((u64)(this->count - index) * sizeof(element));
                 memmove(
                     move_dst,
                     move_src,
                     move_size
                 );
-            } 
+            }
 
-            void*       copy_dst = (void*)&this->array[index];
-            const void* copy_src = (void*)&elmnt;
-            memccpy(
-                copy_dst,
-                copy_src,
-                element_size
+            // an aliased source below index stayed put, the part of it at or past
+            // index moved up with the tail. copy the two parts either side of the gap
+            u32 count_low = count;
+            if (is_aliased) {
+                count_low = (index_source < index) ? (index - index_source) : 0;
+                count_low = (count_low < count) ? count_low : count;
+            }
+
+            const element* source_low  = is_aliased ? &this->array[index_source]                     : elmnts;
+            const element* source_high = is_aliased ? &this->array[index_source + count_low + count] : NULL;
+
+            memcpy(
+                (void*)&this->array[index],
+                (void*)source_low,
+                ((u64)count_low * sizeof(element))
             );
-            ++this->count;
+            if (count_low < count) {
+                memcpy(
+                    (void*)&this->array[index + count_low],
+                    (void*)source_high,
+                    ((u64)(count - count_low) * sizeof(element))
+                );
+            }
+            this->count = count_required;
         }
 
         return(can_add);
@@ -271,7 +389,7 @@ namespace sld {
     SLD_API_INLINE_ARRAY_LIST
     remove(
         const element* elmnt) -> void {
-    
+
         const u32 index = this->index_of(elmnt);
         assert(
             index != ARRAY_LIST_INVALID_INDEX &&
@@ -283,19 +401,48 @@ namespace sld {
     SLD_API_INLINE_ARRAY_LIST
     remove_at(
         const u32 index) -> void {
-    
+
+        this->remove_range(index, 1);
+    }
+
+    SLD_API_INLINE_ARRAY_LIST
+    remove_range(
+        const u32 index,
+        const u32 count) -> void {
+
         assert(
             this->is_valid() &&
-            index != ARRAY_LIST_INVALID_INDEX &&
-            index <  this->count;
+            index <= this->count &&
+            count <= (this->count - index)
         );
-    
-        if (index < (this->count - 1)) {
+
+        // shift the tail down once for the whole range
+        const u32 index_tail = (index + count);
+        if (index_tail < this->count) {
             void*       dst  = (void*)&this->array[index];
-            const void* src  = (void*)&this->array[index + 1];
-            const u32   size = (this->count - index) * sizeof(element); 
+            const void* src  = (void*)&this->array[index_tail];
+            const u64   size = ((u64)(this->count - index_tail) * sizeof(element));
             memmove(dst, src, size);
         }
+        this->count -= count;
+    }
+
+    SLD_API_INLINE_ARRAY_LIST
+    remove_swap(
+        const u32 index) -> void {
+
+        // O(1), the last element takes the removed one's place so order isn't kept
+        assert(
+            this->is_valid() &&
+            index < this->count
+        );
+
+        const u32 index_last = (this->count - 1);
+        if (index < index_last) {
+            void*       dst  = (void*)&this->array[index];
+            const void* src  = (void*)&this->array[index_last];
+            memcpy(dst, src, sizeof(element));
+        }
         --this->count;
     }
 
@@ -308,16 +455,12 @@ namespace sld {
             elmnt != NULL
         );
 
-        const intptr_t  start      = this->array; 
-        const ptrdiff_t diff       = elmnt - this->array; 
-        const u32       stride     = sizeof(elmnt);
-        const bool      does_exist = (
-            elmnt >= this->array                    &&
-            elmnt <= (this->array + this->capacity) &&
-            (diff % stride) == 0
+        const bool does_exist = (
+            elmnt >= this->array &&
+            elmnt <  (this->array + this->count)
         );
         const u32 index = does_exist
-            ? (diff / stride)
+            ? (u32)(elmnt - this->array)
             : ARRAY_LIST_INVALID_INDEX;
 
         return(index);
@@ -329,20 +472,45 @@ namespace sld {
 
         this->assert_valid();
 
-        u32 index = ARRAY_LIST_INVALID_INDEX;
+        // integers, enums and pointers compare bitwise, so they can be scanned as
+        // plain u32/u64 lanes instead of one operator== at a time
+        constexpr bool is_bitwise = (
+            std::is_integral <element>::value ||
+            std::is_enum     <element>::value ||
+            std::is_pointer  <element>::value
+        );
+        constexpr bool is_simd_u32 = is_bitwise && (sizeof(element) == sizeof(u32));
+        constexpr bool is_simd_u64 = is_bitwise && (sizeof(element) == sizeof(u64));
+
+        if constexpr (is_simd_u32) {
+            u32 value;
+            memcpy(&value, &elmnt, sizeof(u32));
+            const u32 index = simd_search_u32((const u32*)this->array, this->count, value);
+            return(index);
+        }
+        else if constexpr (is_simd_u64) {
+            u64 value;
+            memcpy(&value, &elmnt, sizeof(u64));
+            const u32 index = simd_search_u64((const u64*)this->array, this->count, value);
+            return(index);
+        }
+        else {
+            u32 index = ARRAY_LIST_INVALID_INDEX;
 
-        const element* tmp_array = this->array;
+            const element* tmp_array = this->array;
 
-        for (
-            u32 i = 0;
-                i < this->count;
-              ++i) {
+            for (
+                u32 i = 0;
+                    i < this->count;
+                  ++i) {
 
-            if (tmp_array[i] == elmnt) {
-                index = i;
+                if (tmp_array[i] == elmnt) {
+                    index = i;
+                    break;
+                }
             }
+            return(index);
         }
-        return(index);
     }
 
     SLD_API_INLINE_ARRAY_LIST
@@ -356,7 +524,7 @@ namespace sld {
         );
 
         element& elmnt = this->array[index];
-        return(elmnt); 
+        return(elmnt);
     }
 
     SLD_API_INLINE_ARRAY_LIST
@@ -370,9 +538,69 @@ namespace sld {
         );
 
         const element& elmnt = this->array[index];
-        return(elmnt); 
+        return(elmnt);
+    }
+
+    SLD_API_INLINE_ARRAY_LIST
+    grow(
+        const u32 count_required) -> bool {
+
+        if (!this->is_growable()) return(false);
+
+        // double until the required count fits
+        u64 capacity_new = this->capacity;
+        while (capacity_new < count_required) {
+            capacity_new *= 2;
+        }
+        if (capacity_new > 0xFFFFFFFF) {
+            capacity_new = 0xFFFFFFFF;
+        }
+
+        const u64 size_old = ((u64)this->capacity * sizeof(element));
+        const u64 size_new = (capacity_new        * sizeof(element));
+
+        element* array_new = NULL;
+        if (this->source_arena) {
+
+            // extend in place if nothing has been pushed after us
+            arena*     source    = this->source_arena;
+            const addr array_end = (addr)this->array + size_old;
+            const bool is_last   = (array_end == (addr)(source->start + source->position));
+            if (is_last) {
+                const byte* extension = source->push_bytes(size_new - size_old);
+                if (extension) {
+                    this->capacity = (u32)capacity_new;
+                    return(true);
+                }
+            }
+            array_new = (element*)source->push_bytes(size_new, alignof(element));
+        }
+        else {
+            heap_node_t* node = (size_new <= 0xFFFFFFFF)
+                ? heap_insert(this->source_heap, (u32)size_new)
+                : NULL;
+            array_new = (node != NULL)
+                ? (element*)heap_node_get_data(node)
+                : NULL;
+        }
+        if (!array_new) return(false);
+
+        memcpy(
+            (void*)array_new,
+            (void*)this->array,
+            ((u64)this->count * sizeof(element))
+        );
+
+        if (this->source_heap) {
+            heap_node_t* node_old = heap_node_from_data(this->array);
+            (void)heap_remove(this->source_heap, node_old);
+        }
+
+        this->array    = array_new;
+        this->capacity = (u32)capacity_new;
+        return(true);
     }
 };
 
 
-#endif //SLD_ARRAY_LIST_HPP
\ No newline at end of file
+#endif //SLD_ARRAY_LIST_HPP
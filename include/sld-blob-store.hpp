@@ -0,0 +1,110 @@
+#ifndef SLD_BLOB_STORE_HPP
+#define SLD_BLOB_STORE_HPP
+
+#include "sld.hpp"
+#include "sld-arena.hpp"
+#include "sld-hash.hpp"
+#include "sld-hash-table.hpp"
+#include "sld-block-allocator.hpp"
+#include "sld-os-file.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // BLOB STORE
+    //-------------------------------------------------------------------
+
+    // NOTE(SAM): every distinct payload is written once and found again by its
+    // 128 bit hash, adding the same bytes twice gives back the same id with one
+    // more reference. ids are handed out in order and never reused, like the
+    // string intern.
+    //
+    // the store is one file mapped writable at a fixed capacity. it starts with a
+    // header and everything after it is appended, each blob is a record header
+    // and its payload on a 16 byte boundary, so get_data points straight into the map.
+    // flush appends an index record of every entry and points the header at it,
+    // open loads the newest index and then picks up any blobs written after it.
+    //
+    // reference counts only live in memory, a reopened store starts everything
+    // at zero. a blob at zero keeps its bytes and can come back with add, nothing
+    // is taken out of the file, there's no compaction yet. not thread safe
+    constexpr u64 BLOB_STORE_MAGIC            = 0x31424F4C42444C53; // "SLDBLOB1"
+    constexpr u32 BLOB_STORE_VERSION          = 1;
+    constexpr u32 BLOB_STORE_INVALID_ID       = 0xFFFFFFFF;
+    constexpr u64 BLOB_STORE_RECORD_ALIGNMENT = 16;
+    constexpr u32 BLOB_STORE_ENTRY_BLOCK_SIZE = (64 * 1024);
+
+    struct blob_store_t;
+    struct blob_store_entry_t;
+    struct blob_store_record_t;
+    struct blob_store_file_header_t;
+
+    enum blob_store_record_kind_e : u32 {
+        blob_store_record_kind_e_none  = 0,
+        blob_store_record_kind_e_blob  = 1,
+        blob_store_record_kind_e_index = 2
+    };
+
+    // the file isn't closed with the store, it belongs to the caller and has to be
+    // open for read and write. size_capacity is rounded up to the map granularity
+    SLD_API bool        blob_store_open          (blob_store_t&       store, arena* arena, const os_file_handle file_hnd, const u64 size_capacity, const u32 count_max);
+    SLD_API bool        blob_store_close         (blob_store_t&       store);
+    SLD_API bool        blob_store_validate      (const blob_store_t& store);
+    SLD_API bool        blob_store_flush         (blob_store_t&       store);
+    SLD_API u32         blob_store_add           (blob_store_t&       store, const byte*      data, const u64 size);
+    SLD_API u32         blob_store_find          (const blob_store_t& store, const byte*      data, const u64 size);
+    SLD_API u32         blob_store_find_hash     (const blob_store_t& store, const hash128_t& hash);
+    SLD_API bool        blob_store_acquire       (blob_store_t&       store, const u32        id);
+    SLD_API bool        blob_store_release       (blob_store_t&       store, const u32        id);
+    SLD_API const byte* blob_store_get_data      (const blob_store_t& store, const u32        id);
+    SLD_API u32         blob_store_get_size      (const blob_store_t& store, const u32        id);
+    SLD_API bool        blob_store_get_hash      (const blob_store_t& store, const u32        id, hash128_t& hash);
+    SLD_API u32         blob_store_get_ref_count (const blob_store_t& store, const u32        id);
+    SLD_API u32         blob_store_get_count     (const blob_store_t& store);
+    SLD_API u64         blob_store_get_size_used (const blob_store_t& store);
+
+    // written as is, so the layouts are fixed
+    struct blob_store_file_header_t {
+        u64 magic;
+        u32 version;
+        u32 reserved;
+        u64 size_used;
+        u64 index_offset;
+        u64 padding[4];
+    };
+
+    struct blob_store_record_t {
+        hash128_t hash;
+        u64       size;
+        u32       kind;
+        u32       reserved;
+    };
+
+    // the index record's payload is an array of these, the ref count isn't
+    // kept and reads back as zero
+    struct blob_store_entry_t {
+        hash128_t hash;
+        u64       offset;
+        u32       size;
+        u32       ref_count;
+    };
+
+    // entries live in blocks committed as the count grows, the table maps a
+    // blob's hash to its id
+    struct blob_store_t {
+        os_file_handle            file;
+        os_file_map_handle        map;
+        os_file_mapped_buffer     view;
+        blob_store_file_header_t* header;
+        u64                       size_capacity;
+        u32                       count;
+        u32                       count_max;
+        u32                       count_indexed;
+        u32                       entry_per_block;
+        block_allocator_t         entry_blocks;
+        blob_store_entry_t**      entry_block_array;
+        hash_table_t              table;
+    };
+};
+
+#endif //SLD_BLOB_STORE_HPP
@@ -0,0 +1,80 @@
+#ifndef SLD_BLOCK_ALLOCATOR_HPP
+#define SLD_BLOCK_ALLOCATOR_HPP
+
+#include <new>
+#include <atomic>
+
+#include "sld.hpp"
+#include "sld-memory.hpp"
+#include "sld-os-memory.hpp"
+#include "sld-alloc-tracker.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // BLOCK ALLOCATOR
+    //-------------------------------------------------------------------
+
+    constexpr u32 BLOCK_ALLOCATOR_INVALID_INDEX = 0xFFFFFFFF;
+
+    struct block_allocator_t;
+    struct block_allocator_atomic_t;
+
+    enum block_allocator_flag_e : u32 {
+        block_allocator_flag_e_none        = 0,
+        block_allocator_flag_e_large_pages = bit_value(0)
+    };
+
+    SLD_API bool     block_allocator_validate          (const block_allocator_t* allocator);
+    SLD_API bool     block_allocator_reserve_os_memory (block_allocator_t*       allocator, const u64   size_total, const u32 size_block, const bool use_large_pages = false);
+    SLD_API bool     block_allocator_release_os_memory (block_allocator_t*       allocator);
+    SLD_API void*    block_allocator_commit            (block_allocator_t*       allocator SLD_ALLOC_SITE_PARAMS);
+    SLD_API memory_t block_allocator_commit_memory     (block_allocator_t*       allocator SLD_ALLOC_SITE_PARAMS);
+    SLD_API bool     block_allocator_decommit          (block_allocator_t*       allocator, void*       block);
+    SLD_API u32      block_allocator_get_block_index   (const block_allocator_t* allocator, const void* block);
+
+    //-------------------------------------------------------------------
+    // BLOCK ALLOCATOR ATOMIC
+    //-------------------------------------------------------------------
+
+    // NOTE(SAM): same reserve/commit model, but commit and decommit can be called
+    // from any thread. free blocks are a lock-free stack of indices, the head
+    // carries a tag in the high bits that changes on every update so a stale pop can't win (ABA)
+
+    SLD_API bool     block_allocator_atomic_validate          (const block_allocator_atomic_t* allocator);
+    SLD_API bool     block_allocator_atomic_reserve_os_memory (block_allocator_atomic_t*       allocator, const u64   size_total, const u32 size_block, const bool use_large_pages = false);
+    SLD_API bool     block_allocator_atomic_release_os_memory (block_allocator_atomic_t*       allocator);
+    SLD_API void*    block_allocator_atomic_commit            (block_allocator_atomic_t*       allocator);
+    SLD_API memory_t block_allocator_atomic_commit_memory     (block_allocator_atomic_t*       allocator);
+    SLD_API bool     block_allocator_atomic_decommit          (block_allocator_atomic_t*       allocator, void*       block);
+    SLD_API u32      block_allocator_atomic_get_block_index   (const block_allocator_atomic_t* allocator, const void* block);
+
+    struct block_allocator_t {
+        addr start;
+        u64  size_reserved;
+        addr blocks;
+        u32  block_size;
+        u32  block_count;
+        u32  block_count_fresh;
+        u32  free_count;
+        u32* free_stack;
+        u32  flags;
+    #if SLD_ALLOC_TRACKING
+        alloc_tracker_t* tracker; // optional, set after reserve
+    #endif
+    };
+
+    struct block_allocator_atomic_t {
+        addr              start;
+        u64               size_reserved;
+        addr              blocks;
+        u32               block_size;
+        u32               block_count;
+        u32               flags;
+        std::atomic<u32>  block_count_fresh;
+        std::atomic<u64>  free_head;
+        std::atomic<u32>* free_next;
+    };
+};
+
+#endif //SLD_BLOCK_ALLOCATOR_HPP
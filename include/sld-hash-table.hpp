@@ -1,31 +1,85 @@
 #ifndef SLD_HASH_TABLE_HPP
 #define SLD_HASH_TABLE_HPP
 
+#include <atomic>
+
 #include "sld.hpp"
 #include "sld-hash.hpp"
 #include "sld-memory.hpp"
 
+#define SLD_HASH_TABLE_ALIGN_SHARD alignas(64)
+
 namespace sld {
 
+    //-------------------------------------------------------------------
+    // HASH TABLE
+    //-------------------------------------------------------------------
+
+    // NOTE(SAM): open addressing over groups of 16 slots. every slot has a control
+    // byte, either empty or a 7 bit tag from the hash, and a whole group is checked
+    // with one SSE2 compare + movemask. keys aren't stored, a key is its 128 bit hash.
+    //
+    // there are no tombstones. each group counts how many entries probed past it
+    // while it was full, a lookup stops at the first group whose count is zero, and a
+    // remove just empties the slot and takes one off every group it had passed.
+    // so removes don't degrade probe lengths and the table never needs cleaning up
+    constexpr u32 HASH_TABLE_GROUP_SIZE           = 16;
+    constexpr u32 HASH_TABLE_INVALID_INDEX        = 0xFFFFFFFF;
+    constexpr u32 HASH_TABLE_DEFAULT_LOAD_PERCENT = 87;
+    constexpr u8  HASH_TABLE_CONTROL_EMPTY        = 0x80;
+    constexpr u8  HASH_TABLE_OVERFLOW_MAX         = 0xFF;
+
     struct hash_table_t;
     struct hash_table_key_t;
     struct hash_table_value_t;
     struct hash_table_kv_pair_t;
     struct hash_table_error_t;
 
-    SLD_API const u32 hash_table_memory_size    (const hash_table_t& hash_table);
-    SLD_API bool      hash_table_memory_init    (hash_table_t&       hash_table, const memory_t& memory);
+    SLD_API const u64 hash_table_memory_size    (const u32           capacity,   const u32               stride);
+    SLD_API bool      hash_table_memory_init    (hash_table_t&       hash_table, const memory_t&         memory, const u32 capacity, const u32 stride, const u32 load_percent = HASH_TABLE_DEFAULT_LOAD_PERCENT);
     SLD_API bool      hash_table_validate       (const hash_table_t& hash_table);
-    SLD_API bool      hash_table_validate_key   (const hash_table_t& hash_table, const hash_table_key_t&   key);
+    SLD_API bool      hash_table_validate_key   (const hash_table_key_t& key);
     SLD_API bool      hash_table_validate_value (const hash_table_t& hash_table, const hash_table_value_t& value);
     SLD_API bool      hash_table_reset          (hash_table_t&       hash_table);
-    SLD_API bool      hash_table_insert         (hash_table_t&       hash_table, const byte*             value, hash_table_key_t& key);
-    SLD_API bool      hash_table_insert_at      (hash_table_t&       hash_table, const byte*             data, const u32 index, hash_t& key);
-    SLD_API bool      hash_table_remove_at      (hash_table_t&       hash_table, const u32               index);
+    SLD_API bool      hash_table_rehash         (hash_table_t&       hash_table, const memory_t&         memory, const u32           capacity);
+    SLD_API bool      hash_table_insert         (hash_table_t&       hash_table, const hash_table_key_t& key,    const byte*         value);
     SLD_API bool      hash_table_remove         (hash_table_t&       hash_table, const hash_table_key_t& key);
-    SLD_API bool      hash_table_search         (const hash_table_t& hash_table, const hash_table_key_t& key,   hash_table_value_t& value);
-    SLD_API bool      hash_table_get_key_at     (const hash_table_t& hash_table, const u32               index, hash_table_key_t&   key);
-    SLD_API bool      hash_table_get_value_at   (const hash_table_t& hash_table, const u32               index, hash_table_value_t& value);
+    SLD_API bool      hash_table_remove_at      (hash_table_t&       hash_table, const u32               index);
+    SLD_API bool      hash_table_search         (const hash_table_t& hash_table, const hash_table_key_t& key,    hash_table_value_t& value);
+    SLD_API bool      hash_table_get_hash_at    (const hash_table_t& hash_table, const u32               index,  hash128_t&          hash);
+    SLD_API bool      hash_table_get_value_at   (const hash_table_t& hash_table, const u32               index,  hash_table_value_t& value);
+    SLD_API hash128_t hash_table_hash_key       (const hash_table_key_t& key);
+
+    // same as above with the key already hashed, for callers that hash once and
+    // use the result for more than one lookup
+    SLD_API bool      hash_table_insert_hash    (hash_table_t&       hash_table, const hash128_t&        hash,   const byte*         value);
+    SLD_API bool      hash_table_remove_hash    (hash_table_t&       hash_table, const hash128_t&        hash);
+    SLD_API bool      hash_table_search_hash    (const hash_table_t& hash_table, const hash128_t&        hash,   hash_table_value_t& value);
+
+    //-------------------------------------------------------------------
+    // HASH TABLE SHARDED
+    //-------------------------------------------------------------------
+
+    // NOTE(SAM): a power of two number of hash tables, the hash picks the shard.
+    // each shard has a sequence number that writers make odd while they work,
+    // readers don't write anything, they copy the value out and retry if the
+    // sequence changed underneath them. writers only contend within a shard
+    constexpr u32 HASH_TABLE_SHARD_COUNT_MAX = 1024;
+
+    struct hash_table_sharded_t;
+    struct hash_table_shard_t;
+
+    SLD_API const u64 hash_table_sharded_memory_size (const u32                   shard_count, const u32        capacity, const u32 stride);
+    SLD_API bool      hash_table_sharded_memory_init (hash_table_sharded_t&       sharded,     const memory_t&  memory,   const u32 shard_count, const u32 capacity, const u32 stride, const u32 load_percent = HASH_TABLE_DEFAULT_LOAD_PERCENT);
+    SLD_API bool      hash_table_sharded_validate    (const hash_table_sharded_t& sharded);
+    SLD_API bool      hash_table_sharded_reset       (hash_table_sharded_t&       sharded);
+    SLD_API u32       hash_table_sharded_get_count   (const hash_table_sharded_t& sharded);
+    SLD_API bool      hash_table_sharded_insert      (hash_table_sharded_t&       sharded,     const hash_table_key_t& key,  const byte* value);
+    SLD_API bool      hash_table_sharded_insert_hash (hash_table_sharded_t&       sharded,     const hash128_t&        hash, const byte* value);
+    SLD_API bool      hash_table_sharded_remove      (hash_table_sharded_t&       sharded,     const hash_table_key_t& key);
+    SLD_API bool      hash_table_sharded_remove_hash (hash_table_sharded_t&       sharded,     const hash128_t&        hash);
+    SLD_API bool      hash_table_sharded_search      (const hash_table_sharded_t& sharded,     const hash_table_key_t& key,  byte*       value);
+    SLD_API bool      hash_table_sharded_search_hash (const hash_table_sharded_t& sharded,     const hash128_t&        hash, byte*       value);
 
     struct hash_table_error_t : s32_t { };
 
@@ -33,16 +87,33 @@ namespace sld {
         u32                capacity;
         u32                stride;
         u32                count;
+        u32                count_max;
+        u32                group_mask;
+        u32                load_percent;
         hash_table_error_t error;
         struct {
-            hash_t* hash;
-            byte*   value;
+            hash128_t* hash;
+            byte*      value;
+            u8*        control;
+            u8*        overflow;
         } array;
     };
 
+    struct SLD_HASH_TABLE_ALIGN_SHARD hash_table_shard_t {
+        std::atomic<u32> sequence;
+        hash_table_t     table;
+    };
+
+    struct hash_table_sharded_t {
+        u32                 shard_count;
+        u32                 shard_mask;
+        u32                 stride;
+        hash_table_shard_t* shards;
+    };
+
     struct hash_table_key_t {
-        byte* data;
-        u64   length;
+        const byte* data;
+        u64         length;
     };
 
     struct hash_table_value_t {
@@ -51,8 +122,8 @@ namespace sld {
     };
 
     struct hash_table_kv_pair_t {
-        hash_table_key_t   key; 
-        hash_table_value_t value; 
+        hash_table_key_t   key;
+        hash_table_value_t value;
     };
 
     enum hash_table_error_e {
@@ -63,8 +134,10 @@ namespace sld {
         hash_table_error_e_not_enough_memory   = -4,
         hash_table_error_e_max_count           = -5,
         hash_table_error_e_hash_failed         = -6,
-        hash_table_error_e_index_out_of_bounds = -7
+        hash_table_error_e_index_out_of_bounds = -7,
+        hash_table_error_e_key_exists          = -8,
+        hash_table_error_e_key_not_found       = -9
     };
 };
 
-#endif //SLD_HASH_TABLE_HPP
\ No newline at end of file
+#endif //SLD_HASH_TABLE_HPP
@@ -3,6 +3,7 @@
 
 #include <meow-hash/meow_hash_x64_aesni.h>
 #include "sld.hpp"
+#include "sld-os-file.hpp"
 
 #define SLD_HASH_ALIGN_128 alignas(16)
 #define SLD_HASH_ALIGN_32  alignas(4)
@@ -20,15 +21,27 @@ namespace sld {
     struct hash32_t;
     struct hash32_seed_t;
 
+    struct job_system_t;
+
     //-------------------------------------------------------------------
     // HASH 128
     //-------------------------------------------------------------------
 
+    // NOTE(SAM): search scans an array of hashes, split scans the same hashes
+    // stored as separate low and high u64 arrays (see hash128_split), which
+    // compares twice as many per register. sorted is for big indexes kept in
+    // hash128_compare order, it's an interpolation search on the low half
+    constexpr u32 HASH128_SEARCH_INTERPOLATION_STEPS = 8;
+
     SLD_API const hash128_t hash128_data          (const hash128_seed_t& seed,  const byte*           data,   const u32        length);
     SLD_API bool            hash128_data_batch    (const hash128_seed_t& seed,  const u32             count,  const byte*      data,   const u32  stride, hash128_t* hashes);
     SLD_API bool            hash128_is_equal      (const hash128_seed_t& seed,  const byte*           data_a, const byte*      data_b, const u32  length);
     SLD_API bool            hash128_is_equal      (const hash128_seed_t& seed,  const hash128_t&      hash,   const byte*      data,   const u32  length);
     SLD_API bool            hash128_search        (const u32             count, const hash128_t       search, const hash128_t* array,  u32&       index);
+    SLD_API bool            hash128_search_split  (const u32             count, const hash128_t       search, const u64*       array_low, const u64* array_high, u32& index);
+    SLD_API bool            hash128_search_sorted (const u32             count, const hash128_t       search, const hash128_t* array,  u32&       index);
+    SLD_API void            hash128_split         (const u32             count, const hash128_t*      array,  u64*             array_low, u64*       array_high);
+    SLD_API s32             hash128_compare       (const hash128_t&      hash_a, const hash128_t&     hash_b);
     SLD_API void            hash128_block_begin   (hash128_state_t&      state, const hash128_seed_t& seed);
     SLD_API void            hash128_block_consume (hash128_state_t&      state, const u64             block_size, const byte* block_data);
     SLD_API const hash128_t hash128_block_end     (hash128_state_t&      state);
@@ -37,7 +50,7 @@ namespace sld {
         union {
             u32  as_u32   [4];
             u64  as_u64   [2];
-            u32  as_u16   [8];
+            u16  as_u16   [8];
             byte as_bytes [16];
         } val;
     };
@@ -68,6 +81,43 @@ namespace sld {
     struct hash32_seed_t {
         u32 val;
     }; 
+
+    //-------------------------------------------------------------------
+    // PARALLEL
+    //-------------------------------------------------------------------
+
+    // NOTE(SAM): same results as the batch functions, split across the job system.
+    // every range is a whole number of cache lines of output, so with a 64 byte
+    // aligned hashes array no two workers ever write the same line. small batches
+    // aren't worth waking workers for and just run the serial version
+    constexpr u64 HASH_PARALLEL_SIZE_MIN   = (256 * 1024);
+    constexpr u64 HASH_PARALLEL_SIZE_RANGE = (64  * 1024);
+    constexpr u32 HASH_PARALLEL_LINE_SIZE  = 64;
+
+    SLD_API bool hash128_data_batch_parallel (job_system_t& jobs, const hash128_seed_t& seed, const u32   count, const byte*     data,  const u32 stride, hash128_t* hashes);
+    SLD_API bool hash32_batch_parallel       (job_system_t& jobs, const hash32_seed_t   seed, const byte* data,  const u32       stride, const u32 count,  hash32_t*  hashes);
+
+    // NOTE(SAM): one crc over a big buffer, cut into chunks that are crc'd on the
+    // workers from zero and folded back together in order with zng_crc32_combine.
+    // bit identical to hash32. crc runs at many GB/s on one core, so it takes a
+    // lot more data than the batches before this pays for the wake ups
+    constexpr u64 HASH32_PARALLEL_SIZE_MIN   = (1024 * 1024);
+    constexpr u64 HASH32_PARALLEL_CHUNK_SIZE = (256  * 1024);
+    constexpr u32 HASH32_PARALLEL_CHUNK_MAX  = 256;
+
+    SLD_API const hash32_t hash32_parallel (job_system_t& jobs, const hash32_seed_t seed, const byte* data, const u32 length);
+
+    //-------------------------------------------------------------------
+    // FILE
+    //-------------------------------------------------------------------
+
+    // NOTE(SAM): streams a whole file through the block hash in mapped windows, so a
+    // file of any size hashes without a copy into a heap buffer. the next window is
+    // mapped and prefetched before we hash the current one, the disk reads ahead
+    // while we hash. same result as the block functions over the whole file
+    constexpr u64 HASH128_FILE_WINDOW_SIZE = (64 * 1024 * 1024);
+
+    SLD_API bool hash128_file (const hash128_seed_t& seed, const os_file_handle file_hnd, hash128_t& hash);
 };
 
 #endif //SLD_HASH_HPP
\ No newline at end of file
@@ -8,16 +8,57 @@
 
 namespace sld {
 
+    //-------------------------------------------------------------------
+    // HEAP | TLSF (TWO LEVEL SEGREGATED FIT)
+    //-------------------------------------------------------------------
+
+    // NOTE(SAM): sizes map to a first level power of two and a second level
+    // linear subdivision of it, each pair has a free list and bitmaps track
+    // which lists are non-empty, so insert and remove are O(1)
+    constexpr u64 HEAP_ALIGN_SIZE_LOG2  = 3;
+    constexpr u64 HEAP_ALIGN_SIZE       = (1 << HEAP_ALIGN_SIZE_LOG2);
+    constexpr u32 HEAP_SL_COUNT_LOG2    = 5;
+    constexpr u32 HEAP_SL_COUNT         = (1 << HEAP_SL_COUNT_LOG2);
+    constexpr u32 HEAP_FL_INDEX_MAX     = 32;
+    constexpr u32 HEAP_FL_INDEX_SHIFT   = (HEAP_SL_COUNT_LOG2 + HEAP_ALIGN_SIZE_LOG2);
+    constexpr u32 HEAP_FL_COUNT         = (HEAP_FL_INDEX_MAX - HEAP_FL_INDEX_SHIFT + 1);
+    constexpr u64 HEAP_SMALL_BLOCK_SIZE = (1 << HEAP_FL_INDEX_SHIFT);
+
     struct heap_t;
-    struct heap_root_t;
     struct heap_node_t;
 
-    SLD_API const u64    heap_memory_size (const u64       heap_size_min);
-    SLD_API bool         heap_validate    (const heap_t*   heap);
-    SLD_API heap_t*      heap_init        (const memory_t& memory, const u64 granularity);
-    SLD_API bool         heap_reset       (heap_t*         heap);
-    SLD_API heap_node_t* heap_insert      (heap_t*         heap, const u32    size);
-    SLD_API bool         heap_remove      (heap_t*         heap, heap_node_t* node);
+    SLD_API const u64    heap_memory_size    (const u64          heap_size_min);
+    SLD_API bool         heap_validate       (const heap_t*      heap);
+    SLD_API heap_t*      heap_init           (const memory_t&    memory, const u64 granularity = SLD_HEAP_DEFAULT_GRANULARITY);
+    SLD_API bool         heap_reset          (heap_t*            heap);
+    SLD_API heap_node_t* heap_insert         (heap_t*            heap,   const u32    size);
+    SLD_API bool         heap_remove         (heap_t*            heap,   heap_node_t* node);
+    SLD_API byte*        heap_node_get_data  (const heap_node_t* node);
+    SLD_API u64          heap_node_get_size  (const heap_node_t* node);
+    SLD_API heap_node_t* heap_node_from_data (const void*        data);
+
+    struct heap_node_t {
+
+        // only valid if the previous node is free
+        heap_node_t* prev_physical;
+
+        // size of the data, the low bits are the free flags
+        u64          size;
+
+        // only valid if this node is free, otherwise this is the start of the data
+        heap_node_t* next_free;
+        heap_node_t* prev_free;
+    };
+
+    struct heap_t {
+        memory_t     memory;
+        u64          granularity;
+        u64          size_pool;
+        u32          fl_bitmap;
+        u32          sl_bitmap  [HEAP_FL_COUNT];
+        heap_node_t  null_node;
+        heap_node_t* free_lists [HEAP_FL_COUNT][HEAP_SL_COUNT];
+    };
 };
 
-#endif //SLD_HEAP_HPP
\ No newline at end of file
+#endif //SLD_HEAP_HPP
@@ -0,0 +1,171 @@
+#ifndef SLD_JOB_HPP
+#define SLD_JOB_HPP
+
+#include <atomic>
+
+#include "sld.hpp"
+#include "sld-memory.hpp"
+#include "sld-os-thread.hpp"
+#include "sld-os-fiber.hpp"
+#include "sld-queue-mpmc.hpp"
+
+#define SLD_JOB_ALIGN alignas(64)
+
+#if defined(_MSC_VER)
+#   define SLD_JOB_NOINLINE __declspec(noinline)
+#else
+#   define SLD_JOB_NOINLINE __attribute__((noinline))
+#endif
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // JOB SYSTEM
+    //-------------------------------------------------------------------
+
+    // NOTE(SAM): one worker per logical core, the thread that calls init is
+    // worker 0 and the rest are os threads. every worker owns a chase-lev deque,
+    // it pushes and pops the bottom and everyone else steals from the top, so a
+    // worker mostly runs its own jobs newest first and idle workers take the
+    // oldest ones. threads that aren't workers submit through a shared mpmc queue.
+    //
+    // jobs never block, a job that needs other jobs finished waits on their
+    // counter and runs queued jobs until the counter reaches zero. idle workers
+    // spin for a bit and then sleep on a condition until something is submitted.
+    //
+    // with fibers the worker threads run jobs on a pool of fibers instead. a job
+    // that waits parks its whole fiber and the worker carries on with a fresh one,
+    // the parked fiber is picked back up by whichever worker sees its counter done.
+    // so deep dependency chains don't pile up on one stack and no core sits waiting.
+    // worker 0 isn't a fiber, it still runs jobs while it waits
+    constexpr u32 JOB_WORKER_COUNT_MAX         = 64;
+    constexpr u32 JOB_WORKER_INDEX_INVALID     = 0xFFFFFFFF;
+    constexpr u32 JOB_DEQUE_CAPACITY_DEFAULT   = 1024;
+    constexpr u32 JOB_SPIN_COUNT               = 64;
+    constexpr u32 JOB_FIBER_COUNT_DEFAULT      = 128;
+    constexpr u64 JOB_FIBER_STACK_SIZE_DEFAULT = (64 * 1024);
+
+    struct job_t;
+    struct job_counter_t;
+    struct job_deque_t;
+    struct job_deque_slot_t;
+    struct job_entry_t;
+    struct job_fiber_t;
+    struct job_worker_t;
+    struct job_system_t;
+    struct job_system_config_t;
+
+    using job_function_f     = void (*) (void* data);
+    using job_parallel_for_f = void (*) (const u64 begin, const u64 end, void* data);
+
+    SLD_API void job_system_config_default   (job_system_config_t&       config);
+    SLD_API u64  job_system_memory_size      (const job_system_config_t& config);
+    SLD_API bool job_system_init             (job_system_t&              system, const memory_t& memory, const job_system_config_t& config);
+    SLD_API bool job_system_validate         (const job_system_t&        system);
+    SLD_API void job_system_shutdown         (job_system_t&              system);
+    SLD_API u32  job_system_get_worker_count (const job_system_t&        system);
+    SLD_API u32  job_system_get_worker_index (const job_system_t&        system);
+
+    // the counter goes up by count on submit and down by one as each job finishes,
+    // it can be NULL for fire and forget jobs
+    SLD_API void job_submit                  (job_system_t& system, const job_t* jobs, const u32 count, job_counter_t* counter);
+    SLD_API void job_wait                    (job_system_t& system, job_counter_t& counter);
+    SLD_API bool job_counter_is_done         (const job_counter_t& counter);
+
+    // splits [0, count) into ranges of grain and runs them across the workers,
+    // returns when every range is done. the caller runs ranges too
+    SLD_API void job_parallel_for            (job_system_t& system, const u64 count, const u64 grain, job_parallel_for_f function, void* data);
+
+    // worker_count 0 is one worker per logical core. pinned workers are locked to
+    // the logical core matching their index among the cores the process is allowed
+    // on, the calling thread included. init fails if a worker can't be pinned.
+    // fiber_count 0 turns fibers off, otherwise there are at least two per worker
+    struct job_system_config_t {
+        u32  worker_count;
+        u32  deque_capacity;
+        u32  fiber_count;
+        u64  fiber_stack_size;
+        bool is_pinned;
+    };
+
+    struct job_t {
+        job_function_f function;
+        void*          data;
+    };
+
+    struct job_counter_t {
+        std::atomic<u32> value;
+    };
+
+    struct job_deque_slot_t {
+        std::atomic<job_function_f> function;
+        std::atomic<void*>          data;
+        std::atomic<job_counter_t*> counter;
+    };
+
+    struct job_deque_t {
+        job_deque_slot_t* slots;
+        u32               mask;
+        SLD_JOB_ALIGN
+        std::atomic<s64>  top;
+        SLD_JOB_ALIGN
+        std::atomic<s64>  bottom;
+    };
+
+    // a queued job and the counter it takes one off when it finishes
+    struct job_entry_t {
+        job_t          job;
+        job_counter_t* counter;
+    };
+
+    struct job_fiber_t {
+        os_fiber       fiber;
+        job_counter_t* wait_counter;
+        u32            index;
+    };
+
+    // a fiber a worker switched away from can't go back in a queue until the
+    // switch is done, so the worker remembers it and the fiber that runs next does it
+    struct SLD_JOB_ALIGN job_worker_t {
+        job_deque_t       deque;
+        job_system_t*     system;
+        u32               index;
+        u32               steal_seed;
+        os_thread         thread;
+        os_thread_context context;
+        os_fiber          fiber_thread;
+        job_fiber_t*      fiber_current;
+        job_fiber_t*      fiber_previous;
+        u32               fiber_previous_state;
+    };
+
+    struct job_system_t {
+        u32                        worker_count;
+        u32                        deque_capacity;
+        bool                       is_pinned;
+        job_worker_t*              workers;
+        queue_mpmc_t<job_entry_t>* inject;
+        std::atomic<u32>           is_running;
+        std::atomic<s32>           pending;
+        std::atomic<u32>           sleeping;
+        os_thread_mutex            sleep_mutex;
+        os_thread_condition        sleep_condition;
+        struct {
+            u32                    count;
+            u64                    stack_size;
+            memory_t               stacks;
+            job_fiber_t*           array;
+            queue_mpmc_t<u32>*     free;
+            queue_mpmc_t<u32>*     waiting;
+            std::atomic<u32>       waiting_count;
+        } fibers;
+    };
+
+    enum job_fiber_previous_e {
+        job_fiber_previous_e_none = 0,
+        job_fiber_previous_e_free = 1,
+        job_fiber_previous_e_wait = 2
+    };
+};
+
+#endif //SLD_JOB_HPP
@@ -0,0 +1,74 @@
+#ifndef SLD_MEMORY_HPP
+#define SLD_MEMORY_HPP
+
+#include "sld.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // MEMORY
+    //-------------------------------------------------------------------
+
+    struct memory_t {
+        union {
+            addr  start;
+            void* ptr;
+            byte* bytes;
+        };
+        u64 size;
+    };
+
+    SLD_API_INLINE bool     memory_is_valid   (const memory_t& memory);
+    SLD_API_INLINE memory_t memory_add_offset (const memory_t& memory, const u64  offset);
+    SLD_API_INLINE void*    memory_copy       (void*           dst,    const void* src, const u64 size);
+    SLD_API_INLINE void*    memory_zero       (void*           dst,    const u64   size);
+
+    //-------------------------------------------------------------------
+    // INLINE METHODS
+    //-------------------------------------------------------------------
+
+    SLD_API_INLINE bool
+    memory_is_valid(
+        const memory_t& memory) {
+
+        const bool is_valid = (
+            memory.start != 0 &&
+            memory.size  != 0
+        );
+        return(is_valid);
+    }
+
+    SLD_API_INLINE memory_t
+    memory_add_offset(
+        const memory_t& memory,
+        const u64       offset) {
+
+        assert(offset <= memory.size);
+
+        memory_t memory_offset;
+        memory_offset.start = memory.start + offset;
+        memory_offset.size  = memory.size  - offset;
+        return(memory_offset);
+    }
+
+    SLD_API_INLINE void*
+    memory_copy(
+        void*       dst,
+        const void* src,
+        const u64   size) {
+
+        assert(dst != NULL && src != NULL);
+        return(memmove(dst, src, size));
+    }
+
+    SLD_API_INLINE void*
+    memory_zero(
+        void*     dst,
+        const u64 size) {
+
+        assert(dst != NULL);
+        return(memset(dst, 0, size));
+    }
+};
+
+#endif //SLD_MEMORY_HPP
@@ -0,0 +1,54 @@
+#ifndef SLD_OS_FIBER_HPP
+#define SLD_OS_FIBER_HPP
+
+#include "sld.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // TYPES
+    //-------------------------------------------------------------------
+
+    struct os_fiber;
+
+    using os_fiber_function_f = void (*) (void* data);
+
+    //-------------------------------------------------------------------
+    // METHODS
+    //-------------------------------------------------------------------
+
+    // NOTE(SAM): a fiber is a stack and a saved register state, switching is a plain
+    // function call that returns when something switches back. a thread has to
+    // become a fiber before it can switch to one, and it switches back to that
+    // fiber before it turns back into a thread.
+    //
+    // the fiber function must never return, it switches away for the last time instead.
+    // on linux the fiber runs on the stack memory passed in and keeps its context at
+    // the top of it. win32 fibers always allocate their own stack of the same size,
+    // the memory passed in just holds the start data
+    //
+    // so on win32 the memory only has to be OS_FIBER_START_SIZE, and nothing
+    // should reserve a whole stack for it
+#if defined(_WIN32)
+    constexpr bool OS_FIBER_IS_STACK_OWNED = true;
+#else
+    constexpr bool OS_FIBER_IS_STACK_OWNED = false;
+#endif
+    constexpr u64  OS_FIBER_START_SIZE     = 64;
+
+    SLD_API_OS bool os_fiber_create      (os_fiber& fiber, void* stack, const u64 stack_size, os_fiber_function_f function, void* data);
+    SLD_API_OS bool os_fiber_destroy     (os_fiber& fiber);
+    SLD_API_OS bool os_fiber_from_thread (os_fiber& fiber);
+    SLD_API_OS bool os_fiber_to_thread   (os_fiber& fiber);
+    SLD_API_OS void os_fiber_switch      (os_fiber& fiber_from, os_fiber& fiber_to);
+
+    //-------------------------------------------------------------------
+    // DEFINITIONS
+    //-------------------------------------------------------------------
+
+    struct os_fiber {
+        vptr os_handle;
+    };
+};
+
+#endif //SLD_OS_FIBER_HPP
@@ -69,6 +69,21 @@ namespace sld {
     SLD_API_OS bool           os_file_mapped_buffer_read    (const os_file_handle file_hnd, os_file_mapped_buffer* mapped_buffer);
     SLD_API_OS bool           os_file_mapped_buffer_write   (const os_file_handle file_hnd, os_file_mapped_buffer* mapped_buffer);
 
+    // map
+    // NOTE(SAM): windows into a file for streaming through files too big to map
+    // whole. a view's offset has to be a multiple of the map granularity, prefetch
+    // asks the os to start reading a view in before we touch it. a writable map
+    // grows the file to size first if it's smaller, writable views need one
+    SLD_API_OS u64                os_file_map_get_granularity   (void);
+    SLD_API_OS os_file_map_handle os_file_map_create            (const os_file_handle     file_hnd);
+    SLD_API_OS os_file_map_handle os_file_map_create_writable   (const os_file_handle     file_hnd, const u64 size);
+    SLD_API_OS bool               os_file_map_destroy           (const os_file_map_handle map_hnd);
+    SLD_API_OS bool               os_file_map_view              (const os_file_map_handle map_hnd, const u64 offset, const u64 size, os_file_mapped_buffer* view);
+    SLD_API_OS bool               os_file_map_view_writable     (const os_file_map_handle map_hnd, const u64 offset, const u64 size, os_file_mapped_buffer* view);
+    SLD_API_OS bool               os_file_map_unview            (os_file_mapped_buffer*   view);
+    SLD_API_OS bool               os_file_map_prefetch          (const os_file_mapped_buffer* view);
+    SLD_API_OS bool               os_file_map_flush             (const os_file_mapped_buffer* view);
+
     //-------------------------------------------------------------------
     // DEFINITIONS
     //-------------------------------------------------------------------
@@ -5,6 +5,9 @@
 
 namespace sld {
 
+    //-------------------------------------------------------------------
+    // TYPES
+    //-------------------------------------------------------------------
 
     struct os_thread;
     struct os_thread_context;
@@ -13,24 +16,46 @@ namespace sld {
     struct os_thread_callback_data;
     struct os_thread_error;
 
-    using os_thread_callback_function_f   = void (*) (os_thread_context& context);
-
-    using os_thread_create_f              = bool (os_thread*       thread);
-    using os_thread_destroy_f             = bool (os_thread*       thread);
-    using os_thread_exit_f                = bool (os_thread*       thread);
-    using os_thread_sleep_f               = bool (os_thread*       thread);     
-    using os_thread_yield_f               = bool (os_thread*       thread);
-    using os_thread_join_f                = bool (os_thread*       thread);
-    using os_thread_mutex_create_f        = bool (os_thread_mutex* mutex);
-    using os_thread_mutex_destroy_f       = bool (os_thread_mutex* mutex);
-    using os_thread_mutex_lock_f          = bool (os_thread_mutex* mutex);
-    using os_thread_mutex_unlock_f        = bool (os_thread_mutex* mutex);
-    using os_thread_mutex_lock_f          = bool (os_thread_mutex* mutex);
-    using os_thread_condition_create_f    = bool (void);
-    using os_thread_condition_destroy_f   = bool (void);
-    using os_thread_condition_wait_f      = bool (void);
-    using os_thread_condition_signal_f    = bool (void);
-    using os_thread_condition_broadcast_f = bool (void);
+    using os_thread_callback_function_f = void (*) (os_thread_context& context);
+
+    //-------------------------------------------------------------------
+    // METHODS
+    //-------------------------------------------------------------------
+
+    // thread
+    // the context is read by the new thread, it has to outlive the thread.
+    // get_current is only good for naming and pinning the calling thread, not for join.
+    // affinity takes the index of a logical core among the ones we're allowed on, on
+    // linux that's the calling thread's mask so pin others before pinning yourself
+    SLD_API_OS bool os_thread_create            (os_thread&           thread, os_thread_context& context);
+    SLD_API_OS bool os_thread_join              (os_thread&           thread);
+    SLD_API_OS void os_thread_get_current       (os_thread&           thread);
+    SLD_API_OS bool os_thread_set_name          (os_thread&           thread, const cchar*       name);
+    SLD_API_OS bool os_thread_set_affinity      (os_thread&           thread, const u32          core_index);
+    SLD_API_OS void os_thread_yield             (void);
+    SLD_API_OS void os_thread_sleep             (const u32            ms);
+
+    // mutex
+    SLD_API_OS bool os_thread_mutex_create      (os_thread_mutex&     mutex);
+    SLD_API_OS bool os_thread_mutex_destroy     (os_thread_mutex&     mutex);
+    SLD_API_OS void os_thread_mutex_lock        (os_thread_mutex&     mutex);
+    SLD_API_OS bool os_thread_mutex_try_lock    (os_thread_mutex&     mutex);
+    SLD_API_OS void os_thread_mutex_unlock      (os_thread_mutex&     mutex);
+
+    // condition
+    // wait is called with the mutex locked and returns with it locked again
+    SLD_API_OS bool os_thread_condition_create    (os_thread_condition& condition);
+    SLD_API_OS bool os_thread_condition_destroy   (os_thread_condition& condition);
+    SLD_API_OS void os_thread_condition_wait      (os_thread_condition& condition, os_thread_mutex& mutex);
+    SLD_API_OS void os_thread_condition_signal    (os_thread_condition& condition);
+    SLD_API_OS void os_thread_condition_broadcast (os_thread_condition& condition);
+
+    //-------------------------------------------------------------------
+    // DEFINITIONS
+    //-------------------------------------------------------------------
+
+    // linux keeps 15 characters of a thread name, longer names are cut there on both
+    constexpr u32 OS_THREAD_NAME_SIZE_MAX = 16;
 
     struct os_thread_error : s32_t { };
 
@@ -38,6 +63,10 @@ namespace sld {
         vptr os_handle;
     };
 
+    // NOTE(SAM): mutexes and conditions are pointer sized and live in place,
+    // the os_handle is the os primitive itself rather than a pointer to one,
+    // an SRWLOCK on win32 and a futex word on linux.
+    // they can't be copied or moved after create
     struct os_thread_mutex {
         vptr os_handle;
     };
@@ -53,7 +82,7 @@ namespace sld {
 
     struct os_thread_context {
         os_thread_callback_function_f function;
-        os_thread_callback_data     data;
+        os_thread_callback_data       data;
     };
 
     enum os_thread_error_e {
@@ -62,4 +91,4 @@ namespace sld {
     };
 };
 
-#endif //SLD_OS_THREAD_HPP
\ No newline at end of file
+#endif //SLD_OS_THREAD_HPP
@@ -8,5 +8,6 @@
 #include "sld-os-monitor.hpp"
 #include "sld-os-memory.hpp"
 #include "sld-os-thread.hpp"
+#include "sld-os-fiber.hpp"
 
 #endif //SLD_OS_HPP
\ No newline at end of file
@@ -0,0 +1,262 @@
+#ifndef SLD_QUEUE_MPMC_HPP
+#define SLD_QUEUE_MPMC_HPP
+
+#include <new>
+#include <atomic>
+#include <type_traits>
+
+#include "sld.hpp"
+#include "sld-arena.hpp"
+
+#define SLD_QUEUE_MPMC_IMPL_STATIC template<typename t> inline static auto
+#define SLD_QUEUE_MPMC_IMPL_INLINE template<typename t> inline        auto queue_mpmc_t<t>::
+#define SLD_QUEUE_MPMC_ALIGN       alignas(64)
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // QUEUE MPMC | MULTI PRODUCER MULTI CONSUMER
+    //-------------------------------------------------------------------
+
+    // NOTE(SAM): bounded, lock free, any number of threads on either end.
+    // every slot has a sequence number that says whose turn it is. a slot at
+    // position p is free for the producer that claims p when sequence == p, and
+    // ready for the consumer that claims p when sequence == p + 1. claiming a
+    // position is one CAS on head or tail, then the element is copied and the
+    // sequence is published, so producers and consumers only meet on a slot
+    // when the queue is nearly full or nearly empty.
+    // counters are u32 and wrap, differences are read as signed so capacity
+    // has to stay well under 2^31
+    constexpr u32 QUEUE_MPMC_CAPACITY_MAX = (1u << 30);
+
+    template<typename t>
+    struct queue_mpmc_slot_t {
+        std::atomic<u32> sequence;
+        t                element;
+    };
+
+    template<typename t>
+    struct queue_mpmc_t {
+
+        static_assert(std::is_trivially_copyable<t>::value, "queue_mpmc_t elements are copied without constructors");
+
+        // members, read only after init
+        queue_mpmc_slot_t<t>* slots;
+        u32                   capacity;
+        u32                   mask;
+
+        // producers
+        SLD_QUEUE_MPMC_ALIGN
+        std::atomic<u32> tail;
+
+        // consumers
+        SLD_QUEUE_MPMC_ALIGN
+        std::atomic<u32> head;
+
+        // methods
+        inline bool init           (queue_mpmc_slot_t<t>* slots, const u32 capacity);
+        inline bool is_valid       (void) const;
+        inline void assert_valid   (void) const;
+        inline bool enqueue        (const t& element);
+        inline bool dequeue        (t&       element);
+        inline u32  get_count_used (void) const;
+    };
+
+    template<typename t> inline static auto queue_mpmc_memory_size     (const u32   capacity)                   -> u64;
+    template<typename t> inline static auto queue_mpmc_init_from_arena (arena*      arena,  const u32 capacity) -> queue_mpmc_t<t>*;
+    template<typename t> inline static auto queue_mpmc_init_from_memory(void* const memory, const u64 size)     -> queue_mpmc_t<t>*;
+
+    //-------------------------------------------------------------------
+    // STATIC METHODS
+    //-------------------------------------------------------------------
+
+    SLD_QUEUE_MPMC_IMPL_STATIC
+    queue_mpmc_memory_size(
+        const u32 capacity) -> u64 {
+
+        // the struct followed by the slots, capacity rounded up to a power of two
+        const u64 size_struct = size_round_up_pow2(sizeof(queue_mpmc_t<t>));
+        const u64 size_slots  = size_round_up_pow2(capacity) * sizeof(queue_mpmc_slot_t<t>);
+        const u64 size        = (capacity != 0) ? (size_struct + size_slots) : 0;
+        return(size);
+    }
+
+    SLD_QUEUE_MPMC_IMPL_STATIC
+    queue_mpmc_init_from_arena(
+        arena*    arena,
+        const u32 capacity) -> queue_mpmc_t<t>* {
+
+        assert(arena != NULL);
+
+        const u64 capacity_pow2 = size_round_up_pow2(capacity);
+        if (capacity == 0 || capacity_pow2 > QUEUE_MPMC_CAPACITY_MAX) return(NULL);
+
+        void*                 memory_queue = arena->push_bytes(sizeof(queue_mpmc_t<t>), alignof(queue_mpmc_t<t>));
+        queue_mpmc_slot_t<t>* slots        = (queue_mpmc_slot_t<t>*)arena->push_bytes(
+            capacity_pow2 * sizeof(queue_mpmc_slot_t<t>),
+            alignof(queue_mpmc_slot_t<t>)
+        );
+        if (!memory_queue || !slots) return(NULL);
+
+        // the indices are a line apart, that's only true if the struct starts on one
+        assert(((addr)memory_queue & (alignof(queue_mpmc_t<t>)      - 1)) == 0);
+        assert(((addr)slots        & (alignof(queue_mpmc_slot_t<t>) - 1)) == 0);
+
+        queue_mpmc_t<t>* queue = new (memory_queue) queue_mpmc_t<t>();
+        (void)queue->init(slots, (u32)capacity_pow2);
+        return(queue);
+    }
+
+    SLD_QUEUE_MPMC_IMPL_STATIC
+    queue_mpmc_init_from_memory(
+        void* const memory,
+        const u64   size) -> queue_mpmc_t<t>* {
+
+        // the capacity is the most slots that fit after the struct, rounded down
+        // to a power of two. memory has to be aligned for the struct
+        const u64 size_struct = size_round_up_pow2(sizeof(queue_mpmc_t<t>));
+        const u64 size_slot   = sizeof(queue_mpmc_slot_t<t>);
+
+        bool can_init = true;
+        can_init &= (memory != NULL);
+        can_init &= (((addr)memory & (alignof(queue_mpmc_t<t>) - 1)) == 0);
+        can_init &= (size   >= (size_struct + size_slot));
+        if (!can_init) return(NULL);
+
+        u64 capacity = (size - size_struct) / size_slot;
+        if (capacity > QUEUE_MPMC_CAPACITY_MAX) capacity = QUEUE_MPMC_CAPACITY_MAX;
+        while (!size_is_pow_2(capacity)) capacity &= (capacity - 1);
+
+        queue_mpmc_t<t>*      queue = new (memory) queue_mpmc_t<t>();
+        queue_mpmc_slot_t<t>* slots = (queue_mpmc_slot_t<t>*)(((addr)memory) + size_struct);
+        (void)queue->init(slots, (u32)capacity);
+        return(queue);
+    }
+
+    //-------------------------------------------------------------------
+    // INLINE METHODS
+    //-------------------------------------------------------------------
+
+    SLD_QUEUE_MPMC_IMPL_INLINE
+    init(
+        queue_mpmc_slot_t<t>* slots,
+        const u32             capacity) -> bool {
+
+        // not thread safe, nothing can use the queue until this returns
+        const bool can_init = (
+            slots != NULL            &&
+            size_is_pow_2(capacity)  &&
+            capacity <= QUEUE_MPMC_CAPACITY_MAX
+        );
+        if (!can_init) return(can_init);
+
+        this->slots    = slots;
+        this->capacity = capacity;
+        this->mask     = (capacity - 1);
+        for (u32 index = 0; index < capacity; ++index) {
+            new (&slots[index].sequence) std::atomic<u32>(index);
+        }
+        this->tail.store(0, std::memory_order_relaxed);
+        this->head.store(0, std::memory_order_relaxed);
+        return(can_init);
+    }
+
+    SLD_QUEUE_MPMC_IMPL_INLINE
+    is_valid(
+        void) const -> bool {
+
+        const bool is_valid = (
+            this->slots    != NULL &&
+            this->capacity != 0    &&
+            this->mask     == (this->capacity - 1)
+        );
+        return(is_valid);
+    }
+
+    SLD_QUEUE_MPMC_IMPL_INLINE
+    assert_valid(
+        void) const -> void {
+
+        assert(this->is_valid());
+    }
+
+    SLD_QUEUE_MPMC_IMPL_INLINE
+    enqueue(
+        const t& element) -> bool {
+
+        this->assert_valid();
+
+        queue_mpmc_slot_t<t>* slot     = NULL;
+        u32                   position = this->tail.load(std::memory_order_relaxed);
+        for (;;) {
+            slot = &this->slots[position & this->mask];
+
+            const u32 sequence = slot->sequence.load(std::memory_order_acquire);
+            const s32 diff     = (s32)(sequence - position);
+
+            // the slot is free, try to claim the position
+            if (diff == 0) {
+                const bool is_claimed = this->tail.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed);
+                if (is_claimed) break;
+            }
+
+            // the slot still holds the element from one lap ago, full
+            else if (diff < 0) return(false);
+
+            // another producer got here first
+            else position = this->tail.load(std::memory_order_relaxed);
+        }
+
+        slot->element = element;
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return(true);
+    }
+
+    SLD_QUEUE_MPMC_IMPL_INLINE
+    dequeue(
+        t& element) -> bool {
+
+        this->assert_valid();
+
+        queue_mpmc_slot_t<t>* slot     = NULL;
+        u32                   position = this->head.load(std::memory_order_relaxed);
+        for (;;) {
+            slot = &this->slots[position & this->mask];
+
+            const u32 sequence = slot->sequence.load(std::memory_order_acquire);
+            const s32 diff     = (s32)(sequence - (position + 1));
+
+            // the slot has been published, try to claim the position
+            if (diff == 0) {
+                const bool is_claimed = this->head.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed);
+                if (is_claimed) break;
+            }
+
+            // nothing published here yet, empty
+            else if (diff < 0) return(false);
+
+            // another consumer got here first
+            else position = this->head.load(std::memory_order_relaxed);
+        }
+
+        // hand the slot to the producer one lap ahead
+        element = slot->element;
+        slot->sequence.store(position + this->mask + 1, std::memory_order_release);
+        return(true);
+    }
+
+    SLD_QUEUE_MPMC_IMPL_INLINE
+    get_count_used(
+        void) const -> u32 {
+
+        // a snapshot, claimed positions count even if their copy isn't done
+        const u32 head  = this->head.load(std::memory_order_acquire);
+        const u32 tail  = this->tail.load(std::memory_order_acquire);
+        const s32 count = (s32)(tail - head);
+        return((count > 0) ? (u32)count : 0);
+    }
+};
+
+#endif //SLD_QUEUE_MPMC_HPP
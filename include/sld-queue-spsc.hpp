@@ -0,0 +1,221 @@
+#ifndef SLD_QUEUE_SPSC_HPP
+#define SLD_QUEUE_SPSC_HPP
+
+#include <new>
+#include <atomic>
+#include <type_traits>
+
+#include "sld.hpp"
+#include "sld-arena.hpp"
+
+#define SLD_QUEUE_SPSC_IMPL_STATIC template<typename t> inline static auto
+#define SLD_QUEUE_SPSC_IMPL_INLINE template<typename t> inline        auto queue_spsc_t<t>::
+#define SLD_QUEUE_ALIGN_CACHE_LINE alignas(64)
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // QUEUE SPSC | SINGLE PRODUCER SINGLE CONSUMER
+    //-------------------------------------------------------------------
+
+    // NOTE(SAM): one thread enqueues and one thread dequeues, nothing else.
+    // head and tail are free running counters on their own cache lines, masked
+    // into the array, so full is (tail - head == capacity) with no sentinel.
+    // each side keeps a cached copy of the other side's counter and only reloads
+    // it when the cache says the queue looks full (or empty), so in steady state
+    // neither side touches the other's cache line
+    constexpr u32 QUEUE_SPSC_CAPACITY_MAX = (1u << 31);
+
+    template<typename t>
+    struct queue_spsc_t {
+
+        static_assert(std::is_trivially_copyable<t>::value, "queue_spsc_t elements are copied with memcpy");
+
+        // members, read only after init
+        t*  array;
+        u32 capacity;
+        u32 mask;
+
+        // producer
+        SLD_QUEUE_ALIGN_CACHE_LINE
+        std::atomic<u32> tail;
+        u32              head_cached;
+
+        // consumer
+        SLD_QUEUE_ALIGN_CACHE_LINE
+        std::atomic<u32> head;
+        u32              tail_cached;
+
+        // methods
+        inline bool init           (t* array, const u32 capacity);
+        inline bool is_valid       (void) const;
+        inline void assert_valid   (void) const;
+        inline bool enqueue        (const t& element);
+        inline bool dequeue        (t&       element);
+        inline u32  enqueue_batch  (const t* elements, const u32 count);
+        inline u32  dequeue_batch  (t*       elements, const u32 count);
+        inline u32  get_count_used (void) const;
+    };
+
+    template<typename t> inline static auto queue_spsc_init_from_arena (arena* arena, const u32 capacity) -> queue_spsc_t<t>*;
+
+    //-------------------------------------------------------------------
+    // STATIC METHODS
+    //-------------------------------------------------------------------
+
+    SLD_QUEUE_SPSC_IMPL_STATIC
+    queue_spsc_init_from_arena(
+        arena*    arena,
+        const u32 capacity) -> queue_spsc_t<t>* {
+
+        assert(arena != NULL);
+
+        // capacity is rounded up to a power of two
+        const u64 capacity_pow2 = size_round_up_pow2(capacity);
+        if (capacity == 0 || capacity_pow2 > QUEUE_SPSC_CAPACITY_MAX) return(NULL);
+
+        void* memory_queue = arena->push_bytes(sizeof(queue_spsc_t<t>), alignof(queue_spsc_t<t>));
+        t*    array        = (t*)arena->push_bytes(capacity_pow2 * sizeof(t), alignof(t));
+        if (!memory_queue || !array) return(NULL);
+
+        // the padding between the indices only works if the struct starts on a line
+        assert(((addr)memory_queue & (alignof(queue_spsc_t<t>) - 1)) == 0);
+        assert(((addr)array        & (alignof(t)               - 1)) == 0);
+
+        queue_spsc_t<t>* queue = new (memory_queue) queue_spsc_t<t>();
+        (void)queue->init(array, (u32)capacity_pow2);
+        return(queue);
+    }
+
+    //-------------------------------------------------------------------
+    // INLINE METHODS
+    //-------------------------------------------------------------------
+
+    SLD_QUEUE_SPSC_IMPL_INLINE
+    init(
+        t*        array,
+        const u32 capacity) -> bool {
+
+        // not thread safe, both threads start using the queue after this
+        const bool can_init = (
+            array != NULL            &&
+            size_is_pow_2(capacity)  &&
+            capacity <= QUEUE_SPSC_CAPACITY_MAX
+        );
+        if (!can_init) return(can_init);
+
+        this->array       = array;
+        this->capacity    = capacity;
+        this->mask        = (capacity - 1);
+        this->head_cached = 0;
+        this->tail_cached = 0;
+        this->tail.store(0, std::memory_order_relaxed);
+        this->head.store(0, std::memory_order_relaxed);
+        return(can_init);
+    }
+
+    SLD_QUEUE_SPSC_IMPL_INLINE
+    is_valid(
+        void) const -> bool {
+
+        const bool is_valid = (
+            this->array    != NULL &&
+            this->capacity != 0    &&
+            this->mask     == (this->capacity - 1)
+        );
+        return(is_valid);
+    }
+
+    SLD_QUEUE_SPSC_IMPL_INLINE
+    assert_valid(
+        void) const -> void {
+
+        assert(this->is_valid());
+    }
+
+    SLD_QUEUE_SPSC_IMPL_INLINE
+    enqueue(
+        const t& element) -> bool {
+
+        const bool is_enqueued = (this->enqueue_batch(&element, 1) == 1);
+        return(is_enqueued);
+    }
+
+    SLD_QUEUE_SPSC_IMPL_INLINE
+    dequeue(
+        t& element) -> bool {
+
+        const bool is_dequeued = (this->dequeue_batch(&element, 1) == 1);
+        return(is_dequeued);
+    }
+
+    SLD_QUEUE_SPSC_IMPL_INLINE
+    enqueue_batch(
+        const t*  elements,
+        const u32 count) -> u32 {
+
+        // producer only, returns how many were enqueued
+        this->assert_valid();
+        assert(elements != NULL || count == 0);
+
+        const u32 tail  = this->tail.load(std::memory_order_relaxed);
+        u32       space = this->capacity - (tail - this->head_cached);
+        if (space < count) {
+            this->head_cached = this->head.load(std::memory_order_acquire);
+            space             = this->capacity - (tail - this->head_cached);
+        }
+
+        const u32 count_enqueue = (count < space) ? count : space;
+        if (count_enqueue == 0) return(0);
+
+        // at most two copies, up to the end of the array and then from the start
+        const u32 index       = (tail & this->mask);
+        const u32 count_first = ((this->capacity - index) < count_enqueue) ? (this->capacity - index) : count_enqueue;
+        memcpy(&this->array[index], elements,               count_first                   * sizeof(t));
+        memcpy(&this->array[0],     &elements[count_first], (count_enqueue - count_first) * sizeof(t));
+
+        this->tail.store(tail + count_enqueue, std::memory_order_release);
+        return(count_enqueue);
+    }
+
+    SLD_QUEUE_SPSC_IMPL_INLINE
+    dequeue_batch(
+        t*        elements,
+        const u32 count) -> u32 {
+
+        // consumer only, returns how many were dequeued
+        this->assert_valid();
+        assert(elements != NULL || count == 0);
+
+        const u32 head      = this->head.load(std::memory_order_relaxed);
+        u32       available = (this->tail_cached - head);
+        if (available < count) {
+            this->tail_cached = this->tail.load(std::memory_order_acquire);
+            available         = (this->tail_cached - head);
+        }
+
+        const u32 count_dequeue = (count < available) ? count : available;
+        if (count_dequeue == 0) return(0);
+
+        const u32 index       = (head & this->mask);
+        const u32 count_first = ((this->capacity - index) < count_dequeue) ? (this->capacity - index) : count_dequeue;
+        memcpy(elements,               &this->array[index], count_first                   * sizeof(t));
+        memcpy(&elements[count_first], &this->array[0],     (count_dequeue - count_first) * sizeof(t));
+
+        this->head.store(head + count_dequeue, std::memory_order_release);
+        return(count_dequeue);
+    }
+
+    SLD_QUEUE_SPSC_IMPL_INLINE
+    get_count_used(
+        void) const -> u32 {
+
+        // a snapshot, either side can move it as soon as it's read
+        const u32 head  = this->head.load(std::memory_order_acquire);
+        const u32 tail  = this->tail.load(std::memory_order_acquire);
+        const u32 count = (tail - head);
+        return(count);
+    }
+};
+
+#endif //SLD_QUEUE_SPSC_HPP
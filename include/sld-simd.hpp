@@ -51,6 +51,7 @@ namespace sld {
 
         // Newton-Raphson refinement: y = y * (2 - x*y)
         reg_out = _mm_mul_ps(reg_out, _mm_sub_ps(reg_tmp, _mm_mul_ps(reg, reg_out)));
+        return(reg_out);
     }
 
     //-------------------------------------------------------------------
@@ -63,8 +64,134 @@ namespace sld {
     SLD_INLINE reg_u128_t simd_u128_a_sub_b  (reg_u128_t       reg_a,  const reg_u128_t reg_b); 
     SLD_INLINE reg_u128_t simd_u128_a_mul_b  (reg_u128_t       reg_a,  const reg_u128_t reg_b); 
     SLD_INLINE reg_u128_t simd_u128_a_div_b  (reg_u128_t       reg_a,  const reg_u128_t reg_b);
-    
 
+    //-------------------------------------------------------------------
+    // SEARCH
+    //-------------------------------------------------------------------
+
+    // NOTE(SAM): linear scans for the first element equal to the value. SSE2 is
+    // always there on x64, AVX2 is used when the build targets it (-mavx2 / /arch:AVX2)
+    // and so is AVX-512 for u64 (-mavx512f / /arch:AVX512). each step compares a
+    // whole register and turns the result into bits, so the first hit is just the
+    // lowest set bit
+    constexpr u32 SIMD_SEARCH_INVALID_INDEX = 0xFFFFFFFF;
+
+    SLD_INLINE u32 simd_search_u32 (const u32* array, const u32 count, const u32 value);
+    SLD_INLINE u32 simd_search_u64 (const u64* array, const u32 count, const u64 value);
+
+    SLD_INLINE u32
+    simd_search_u32(
+        const u32* array,
+        const u32  count,
+        const u32  value) {
+
+        assert(array != NULL || count == 0);
+
+        u32 index = 0;
+
+    #if defined(__AVX2__)
+        // 16 per step, two compares folded into one mask
+        const __m256i reg_value = _mm256_set1_epi32((int)value);
+        for (; (index + 16) <= count; index += 16) {
+
+            const __m256i reg_a  = _mm256_loadu_si256((const __m256i*)&array[index]);
+            const __m256i reg_b  = _mm256_loadu_si256((const __m256i*)&array[index + 8]);
+            const u32     mask_a = (u32)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(reg_a, reg_value)));
+            const u32     mask_b = (u32)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(reg_b, reg_value)));
+            const u32     mask   = (mask_a | (mask_b << 8));
+            if (mask != 0) return(index + bit_scan_forward(mask));
+        }
+    #endif
+
+        // 16 per step, four compares folded into one mask
+        const __m128i reg_value_128 = _mm_set1_epi32((int)value);
+        for (; (index + 16) <= count; index += 16) {
+
+            const __m128i reg_cmp_a = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)&array[index]),      reg_value_128);
+            const __m128i reg_cmp_b = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)&array[index + 4]),  reg_value_128);
+            const __m128i reg_cmp_c = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)&array[index + 8]),  reg_value_128);
+            const __m128i reg_cmp_d = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)&array[index + 12]), reg_value_128);
+            const __m128i reg_cmp   = _mm_or_si128(_mm_or_si128(reg_cmp_a, reg_cmp_b), _mm_or_si128(reg_cmp_c, reg_cmp_d));
+            if (_mm_movemask_epi8(reg_cmp) == 0) continue;
+
+            const u32 mask = (
+                ((u32)_mm_movemask_ps(_mm_castsi128_ps(reg_cmp_a)))      |
+                ((u32)_mm_movemask_ps(_mm_castsi128_ps(reg_cmp_b)) << 4) |
+                ((u32)_mm_movemask_ps(_mm_castsi128_ps(reg_cmp_c)) << 8) |
+                ((u32)_mm_movemask_ps(_mm_castsi128_ps(reg_cmp_d)) << 12)
+            );
+            return(index + bit_scan_forward(mask));
+        }
+
+        // 4 per step
+        for (; (index + 4) <= count; index += 4) {
+
+            const __m128i reg  = _mm_loadu_si128((const __m128i*)&array[index]);
+            const u32     mask = (u32)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(reg, reg_value_128)));
+            if (mask != 0) return(index + bit_scan_forward(mask));
+        }
+
+        for (; index < count; ++index) {
+            if (array[index] == value) return(index);
+        }
+        return(SIMD_SEARCH_INVALID_INDEX);
+    }
+
+    SLD_INLINE u32
+    simd_search_u64(
+        const u64* array,
+        const u32  count,
+        const u64  value) {
+
+        assert(array != NULL || count == 0);
+
+        u32 index = 0;
+
+    #if defined(__AVX512F__)
+        // 16 per step, compares give masks directly
+        const __m512i reg_value_512 = _mm512_set1_epi64((long long)value);
+        for (; (index + 16) <= count; index += 16) {
+
+            const __m512i reg_a  = _mm512_loadu_si512((const void*)&array[index]);
+            const __m512i reg_b  = _mm512_loadu_si512((const void*)&array[index + 8]);
+            const u32     mask_a = (u32)_mm512_cmpeq_epi64_mask(reg_a, reg_value_512);
+            const u32     mask_b = (u32)_mm512_cmpeq_epi64_mask(reg_b, reg_value_512);
+            const u32     mask   = (mask_a | (mask_b << 8));
+            if (mask != 0) return(index + bit_scan_forward(mask));
+        }
+    #endif
+
+    #if defined(__AVX2__)
+        // 8 per step, two compares folded into one mask
+        const __m256i reg_value = _mm256_set1_epi64x((long long)value);
+        for (; (index + 8) <= count; index += 8) {
+
+            const __m256i reg_a  = _mm256_loadu_si256((const __m256i*)&array[index]);
+            const __m256i reg_b  = _mm256_loadu_si256((const __m256i*)&array[index + 4]);
+            const u32     mask_a = (u32)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(reg_a, reg_value)));
+            const u32     mask_b = (u32)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(reg_b, reg_value)));
+            const u32     mask   = (mask_a | (mask_b << 4));
+            if (mask != 0) return(index + bit_scan_forward(mask));
+        }
+    #endif
+
+        // 2 per step, SSE2 has no 64 bit compare so both 32 bit halves have to match
+        const __m128i reg_value_128 = _mm_set1_epi64x((long long)value);
+        for (; (index + 2) <= count; index += 2) {
+
+            const __m128i reg       = _mm_loadu_si128((const __m128i*)&array[index]);
+            const __m128i reg_cmp   = _mm_cmpeq_epi32(reg, reg_value_128);
+            const __m128i reg_swap  = _mm_shuffle_epi32(reg_cmp, _MM_SHUFFLE(2, 3, 0, 1));
+            const __m128i reg_match = _mm_and_si128(reg_cmp, reg_swap);
+            const u32     mask      = (u32)_mm_movemask_pd(_mm_castsi128_pd(reg_match));
+            if (mask != 0) return(index + bit_scan_forward(mask));
+        }
+
+        for (; index < count; ++index) {
+            if (array[index] == value) return(index);
+        }
+        return(SIMD_SEARCH_INVALID_INDEX);
+    }
 };
 
 #endif //SLD_SIMD_HPP
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef SLD_SLAB_ALLOCATOR_HPP
+#define SLD_SLAB_ALLOCATOR_HPP
+
+#include <atomic>
+
+#include "sld.hpp"
+#include "sld-block-allocator.hpp"
+
+#ifndef    SLD_SLAB_MAGAZINE_CAPACITY
+#   define SLD_SLAB_MAGAZINE_CAPACITY 32
+#endif
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // SLAB ALLOCATOR
+    //-------------------------------------------------------------------
+
+    // NOTE(SAM): objects are grouped into power of two size classes from 16B to 64KB,
+    // each slab is one block from the block allocator and holds objects of one class.
+    // a magazine is a small per-thread cache of free objects for each class, so most
+    // allocs and frees never touch the shared class lock
+    constexpr u32 SLAB_CLASS_SIZE_MIN_LOG2 = 4;
+    constexpr u32 SLAB_CLASS_SIZE_MAX_LOG2 = 16;
+    constexpr u32 SLAB_CLASS_SIZE_MIN      = (1 << SLAB_CLASS_SIZE_MIN_LOG2);
+    constexpr u32 SLAB_CLASS_SIZE_MAX      = (1 << SLAB_CLASS_SIZE_MAX_LOG2);
+    constexpr u32 SLAB_CLASS_COUNT         = (SLAB_CLASS_SIZE_MAX_LOG2 - SLAB_CLASS_SIZE_MIN_LOG2 + 1);
+    constexpr u32 SLAB_CLASS_INVALID       = 0xFFFFFFFF;
+    constexpr u32 SLAB_HEADER_SIZE         = 64;
+    constexpr u32 SLAB_DEFAULT_BLOCK_SIZE  = size_kilobytes(256);
+    constexpr u32 SLAB_MAGAZINE_CAPACITY   = SLD_SLAB_MAGAZINE_CAPACITY;
+
+    struct slab_allocator_t;
+    struct slab_class_t;
+    struct slab_header_t;
+    struct slab_magazine_t;
+
+    SLD_API bool  slab_allocator_validate          (const slab_allocator_t* slab);
+    SLD_API bool  slab_allocator_reserve_os_memory (slab_allocator_t*       slab, const u64        size_total, const u32 size_block = SLAB_DEFAULT_BLOCK_SIZE, const bool use_large_pages = false);
+    SLD_API bool  slab_allocator_release_os_memory (slab_allocator_t*       slab);
+    SLD_API void* slab_allocator_alloc             (slab_allocator_t*       slab, slab_magazine_t* magazine, const u32 size);
+    SLD_API bool  slab_allocator_free              (slab_allocator_t*       slab, slab_magazine_t* magazine, void*     object);
+    SLD_API u32   slab_allocator_get_class         (const u32               size);
+    SLD_API u32   slab_allocator_get_object_size   (const slab_allocator_t* slab, const void* object);
+    SLD_API void  slab_magazine_init               (slab_magazine_t*        magazine);
+    SLD_API void  slab_magazine_flush              (slab_allocator_t*       slab, slab_magazine_t* magazine);
+
+    struct slab_header_t {
+        u32 class_index;
+        u32 object_size;
+        u32 object_count;
+    };
+
+    struct slab_class_t {
+        std::atomic_flag lock;
+        void*            free_list;
+        addr             slab_cursor;
+        addr             slab_end;
+        u32              object_size;
+        u32              slab_count;
+    };
+
+    struct slab_allocator_t {
+        block_allocator_atomic_t blocks;
+        slab_class_t             classes[SLAB_CLASS_COUNT];
+    };
+
+    // NOTE(SAM): one per thread, if a magazine is NULL the call goes
+    // straight to the shared classes
+    struct slab_magazine_t {
+        u32   count   [SLAB_CLASS_COUNT];
+        void* objects [SLAB_CLASS_COUNT][SLAB_MAGAZINE_CAPACITY];
+    };
+};
+
+#endif //SLD_SLAB_ALLOCATOR_HPP
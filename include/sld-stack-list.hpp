@@ -2,6 +2,7 @@
 #define SLD_STACK_LIST_HPP
 
 #include "sld.hpp"
+#include "sld-alloc-tracker.hpp"
 
 namespace sld {
 
@@ -15,16 +16,19 @@ namespace sld {
         u32 capacity;
         u32 position;
         u32 save;
+    #if SLD_ALLOC_TRACKING
+        alloc_tracker_t* tracker; // optional, set after init
+    #endif
     };
 
     template<typename t> SLD_API_INLINE stack_list_t<t>* stack_list_init_from_memory (const void* memory, const u32 size);
-    template<typename t> SLD_API_INLINE void             stack_list_init_from_aray   (stack_list_t<t>* stack_list, t* array, const u32 capacity);
+    template<typename t> SLD_API_INLINE void             stack_list_init_from_array  (stack_list_t<t>* stack_list, t* array, const u32 capacity);
     template<typename t> SLD_API_INLINE bool             stack_list_is_valid         (stack_list_t<t>* stack_list);
     template<typename t> SLD_API_INLINE void             stack_list_assert_valid     (stack_list_t<t>* stack_list);
     template<typename t> SLD_API_INLINE void             stack_list_reset            (stack_list_t<t>* stack_list);
     template<typename t> SLD_API_INLINE void             stack_list_reset_to_save    (stack_list_t<t>* stack_list);
     template<typename t> SLD_API_INLINE void             stack_list_save_position    (stack_list_t<t>* stack_list);
-    template<typename t> SLD_API_INLINE t*               stack_list_push_element     (stack_list_t<t>* stack_list, const u32 count = 1);
+    template<typename t> SLD_API_INLINE t*               stack_list_push_element     (stack_list_t<t>* stack_list, const u32 count = 1 SLD_ALLOC_SITE_PARAMS);
     template<typename t> SLD_API_INLINE bool             stack_list_pull_element     (stack_list_t<t>* stack_list, const u32 count = 1);
 
     //-------------------------------------------------------------------
@@ -35,9 +39,9 @@ namespace sld {
     SLD_API_INLINE stack_list_t<t>*
     stack_list_init_from_memory(
         const void* memory,
-        const u32   size) ->  {
+        const u32   size) {
 
-        assert(memory != NULL && size != 0);
+        assert(memory != NULL && size > sizeof(stack_list_t<t>));
 
         constexpr u32 size_struct  = sizeof(stack_list_t<t>);
         constexpr u32 size_element = sizeof(t);
@@ -45,13 +49,16 @@ namespace sld {
 
         stack_list_t<t>* stack_list = (stack_list_t<t>*)memory;
 
-        stack_list->array    = (t*)((addr)memory + struct_size);
+        stack_list->array    = (t*)((addr)memory + size_struct);
         stack_list->capacity = size_array / size_element;  
         stack_list->position = 0;
         stack_list->save     = 0;
+    #if SLD_ALLOC_TRACKING
+        stack_list->tracker  = NULL;
+    #endif
 
         stack_list_assert_valid(stack_list);
-        return(stack); 
+        return(stack_list); 
     }
 
     template<typename t>
@@ -67,6 +74,9 @@ namespace sld {
         stack_list->capacity = capacity;
         stack_list->position = 0;
         stack_list->save     = 0;
+    #if SLD_ALLOC_TRACKING
+        stack_list->tracker  = NULL;
+    #endif
         stack_list_assert_valid(stack_list);
     }
 
@@ -79,7 +89,7 @@ namespace sld {
         if (is_valid) {
             is_valid &= (stack_list->array    != NULL);
             is_valid &= (stack_list->capacity != 0);
-            is_valid &= (stack_list->position <  stack_list->capacity);
+            is_valid &= (stack_list->position <= stack_list->capacity);
             is_valid &= (stack_list->save     <= stack_list->position);
         }
         return(is_valid);
@@ -113,9 +123,9 @@ namespace sld {
     }
 
     template<typename t>
-    SLD_API_INLINE    
+    SLD_API_INLINE void
     stack_list_save_position(
-        stack_list_t<t*> stack_list) -> void {
+        stack_list_t<t>* stack_list) {
 
         stack_list_assert_valid(stack_list);
         stack_list->save = stack_list->position;
@@ -124,26 +134,36 @@ namespace sld {
     template<typename t>
     SLD_API_INLINE t*
     stack_list_push_element(
-        stack_list_t<t*> stack_list,
-        const u32        count) {
+        stack_list_t<t>* stack_list,
+        const u32        count
+        SLD_ALLOC_SITE_ARGS) {
 
         stack_list_assert_valid(stack_list);
 
         const u32 new_position = stack_list->position + count;
         
         bool can_push = (new_position <= stack_list->capacity); 
-        if (!can_push) return(NULL);
 
-        t* ptr = &stack_list->array[stack_list->position];
-        stack_list->position = new_position;
+        t* ptr = NULL;
+        if (can_push) {
+            ptr = &stack_list->array[stack_list->position];
+            stack_list->position = new_position;
+        }
 
+    #if SLD_ALLOC_TRACKING
+        if (stack_list->tracker) {
+            const u64 size     = (u64)count        * sizeof(t);
+            const u64 position = (u64)new_position * sizeof(t);
+            alloc_tracker_record_push(stack_list->tracker, size, position, can_push, site_file, site_line);
+        }
+    #endif
         return(ptr);
     }
 
     template<typename t>
     SLD_API_INLINE bool
     stack_list_pull_element(
-        stack_list_t<t*> stack_list,
+        stack_list_t<t>* stack_list,
         const u32        count) {
 
         stack_list_assert_valid(stack_list);
@@ -2,6 +2,7 @@
 #define SLD_STACK_HPP
 
 #include "sld.hpp"
+#include "sld-alloc-tracker.hpp"
 
 #define SLD_API_INLINE_STACK          inline auto stack::
 #define SLD_API_INLINE_STACK_TEMPLATE template<typename struct_type> inline auto stack::
@@ -14,6 +15,10 @@ namespace sld {
 
     constexpr u32 STACK_DEFAULT_ALIGNMENT = 4;
 
+    // NOTE(SAM): the stack can be used from both ends. the bottom is the
+    // regular stack, the top grows down from the end of the buffer and has
+    // its own position and save, so long lived data can go on one side and
+    // scratch on the other without either having to be copied out
     struct stack {
 
         // members        
@@ -21,20 +26,35 @@ namespace sld {
         u32   capacity;
         u32   position;
         u32   save;
+        u32   position_top;
+        u32   save_top;
+    #if SLD_ALLOC_TRACKING
+        alloc_tracker_t* tracker; // optional, set after init
+    #endif
 
         // methods
         inline void  init          (byte* data,     const u32 capacity);
-        inline byte* push          (const u32 size, const u32 alignment = STACK_DEFAULT_ALIGNMENT);
+        inline byte* push          (const u32 size, const u32 alignment = STACK_DEFAULT_ALIGNMENT SLD_ALLOC_SITE_PARAMS);
         inline bool  pull          (const u32 size, const u32 alignment = STACK_DEFAULT_ALIGNMENT);
         inline bool  is_valid      (void) const;
         inline void  assert_valid  (void) const;
         inline void  reset         (void);
         inline void  roll_back     (void);
         inline void  save_position (void);
+        inline u32   get_space_remaining (void) const;
+
+        // top methods
+        inline byte* push_top          (const u32 size, const u32 alignment = STACK_DEFAULT_ALIGNMENT SLD_ALLOC_SITE_PARAMS);
+        inline bool  pull_top          (const u32 size, const u32 alignment = STACK_DEFAULT_ALIGNMENT);
+        inline void  reset_top         (void);
+        inline void  roll_back_top     (void);
+        inline void  save_position_top (void);
 
         // template methods
-        template<typename struct_type> inline struct_type* push_struct (const u32 count = 1);
-        template<typename struct_type> inline bool         pull_struct (const u32 count = 1);
+        template<typename struct_type> inline struct_type* push_struct     (const u32 count = 1 SLD_ALLOC_SITE_PARAMS);
+        template<typename struct_type> inline bool         pull_struct     (const u32 count = 1);
+        template<typename struct_type> inline struct_type* push_struct_top (const u32 count = 1 SLD_ALLOC_SITE_PARAMS);
+        template<typename struct_type> inline bool         pull_struct_top (const u32 count = 1);
     };
 
     //-------------------------------------------------------------------
@@ -54,14 +74,20 @@ namespace sld {
 
         this->data     = data;
         this->capacity = capacity;
-        this->position = 0;
-        this->save     = 0;
+        this->position     = 0;
+        this->save         = 0;
+        this->position_top = 0;
+        this->save_top     = 0;
+    #if SLD_ALLOC_TRACKING
+        this->tracker      = NULL;
+    #endif
     }
 
     SLD_API_INLINE_STACK
     push(
         const u32 size,
-        const u32 alignment) -> byte* {
+        const u32 alignment
+        SLD_ALLOC_SITE_ARGS) -> byte* {
 
         assert(
             this->is_valid() &&
@@ -72,13 +98,21 @@ namespace sld {
             ? size_align_pow_2 (size, alignment)
             : size_align       (size, alignment);
 
+        // the bottom can grow up to wherever the top is
         const u32 new_position = (this->position + size_aligned);
 
         byte* push_data = NULL;
-        if (new_position <= this->capacity) {
+        if (new_position <= (this->capacity - this->position_top)) {
             push_data = &this->data[this->position];
             this->position = new_position;
         }
+
+    #if SLD_ALLOC_TRACKING
+        if (this->tracker) {
+            const u64 position_total = ((u64)new_position + this->position_top);
+            alloc_tracker_record_push(this->tracker, size_aligned, position_total, (push_data != NULL), site_file, site_line);
+        }
+    #endif
         return(push_data);
     }
 
@@ -111,10 +145,12 @@ namespace sld {
         void) const -> bool {
 
         const bool is_valid = (
-            (this->data     != 0)              &&
-            (this->capacity != 0)              &&
-            (this->position <= this->capacity) &&
-            (this->save     <= this->position)
+            (this->data         != 0)                                     &&
+            (this->capacity     != 0)                                     &&
+            (this->position_top <= this->capacity)                        &&
+            (this->position     <= (this->capacity - this->position_top)) &&
+            (this->save         <= this->position)                        &&
+            (this->save_top     <= this->position_top)
         );
         return(is_valid);
     }
@@ -130,9 +166,12 @@ namespace sld {
     reset(
         void) -> void {
 
+        // resets both ends, use reset_top to only drop the top
         this->assert_valid();
-        this->position = 0;
-        this->save     = 0;
+        this->position     = 0;
+        this->save         = 0;
+        this->position_top = 0;
+        this->save_top     = 0;
     }
 
     SLD_API_INLINE_STACK
@@ -151,13 +190,116 @@ namespace sld {
         this->save = this->position;
     }
 
+    SLD_API_INLINE_STACK
+    get_space_remaining(
+        void) const -> u32 {
+
+        this->assert_valid();
+        const u32 remaining = (this->capacity - this->position - this->position_top);
+        return(remaining);
+    }
+
+    // top methods
+    SLD_API_INLINE_STACK
+    push_top(
+        const u32 size,
+        const u32 alignment
+        SLD_ALLOC_SITE_ARGS) -> byte* {
+
+        assert(
+            this->is_valid() &&
+            size != 0
+        );
+
+        const u32 size_aligned = size_is_pow_2(alignment)
+            ? size_align_pow_2 (size, alignment)
+            : size_align       (size, alignment);
+
+        // the end of the buffer isn't aligned to anything, so the pointer is aligned
+        // down and the padding above it counts towards position_top. pull_top only
+        // gives back size_aligned, the padding stays until a reset or roll back
+        const addr align_mask       = size_is_pow_2(alignment) ? ~(addr)(alignment - 1) : ~(addr)0;
+        const addr address_bottom   = (addr)this->data + this->position;
+        const addr address_top      = (addr)this->data + this->capacity - this->position_top;
+        const bool can_fit          = (size_aligned <= (address_top - address_bottom));
+        const addr address_push     = can_fit ? ((address_top - size_aligned) & align_mask) : 0;
+        const u32  new_position_top = can_fit
+            ? (u32)(((addr)this->data + this->capacity) - address_push)
+            : (this->position_top + size_aligned);
+
+        // the top can grow down to wherever the bottom is
+        byte* push_data = NULL;
+        if (can_fit && address_push >= address_bottom) {
+            push_data = (byte*)address_push;
+            this->position_top = new_position_top;
+        }
+
+    #if SLD_ALLOC_TRACKING
+        if (this->tracker) {
+            const u64 position_total = ((u64)this->position + new_position_top);
+            alloc_tracker_record_push(this->tracker, size_aligned, position_total, (push_data != NULL), site_file, site_line);
+        }
+    #endif
+        return(push_data);
+    }
+
+    SLD_API_INLINE_STACK
+    pull_top(
+        const u32 size,
+        const u32 alignment) -> bool {
+
+        assert(
+            this->is_valid() &&
+            size != 0
+        );
+
+        const u32 size_aligned = size_is_pow_2(alignment)
+            ? size_align_pow_2 (size, alignment)
+            : size_align       (size, alignment);
+
+        const bool can_pull = (size_aligned <= this->position_top); 
+        if (can_pull) {
+            this->position_top -= size_aligned;
+            if (this->position_top < this->save_top) {
+                this->save_top = 0;
+            }
+        }
+        return(can_pull);
+    }
+
+    SLD_API_INLINE_STACK
+    reset_top(
+        void) -> void {
+
+        this->assert_valid();
+        this->position_top = 0;
+        this->save_top     = 0;
+    }
+
+    SLD_API_INLINE_STACK
+    roll_back_top(
+        void) -> void {
+
+        this->assert_valid();
+        this->position_top = this->save_top;
+    }
+
+    SLD_API_INLINE_STACK
+    save_position_top(
+        void) -> void {
+
+        this->assert_valid();
+        this->save_top = this->position_top;
+    }
+
     // template methods
     SLD_API_INLINE_STACK_TEMPLATE
     push_struct(
-        const u32 count) -> struct_type* {
+        const u32 count
+        SLD_ALLOC_SITE_ARGS) -> struct_type* {
 
         const u32    struct_size = sizeof(struct_type) * count;
-        struct_type* struct_inst = (struct_type*)this->push(struct_size);
+        struct_type* struct_inst = (struct_type*)this->push(struct_size, STACK_DEFAULT_ALIGNMENT SLD_ALLOC_SITE_FORWARD);
         return(struct_inst);
     }
     
@@ -169,6 +311,25 @@ namespace sld {
         const bool did_pull    = this->pull(struct_size); 
         return(did_pull);
     }
+
+    SLD_API_INLINE_STACK_TEMPLATE
+    push_struct_top(
+        const u32 count
+        SLD_ALLOC_SITE_ARGS) -> struct_type* {
+
+        const u32    struct_size = sizeof(struct_type) * count;
+        struct_type* struct_inst = (struct_type*)this->push_top(struct_size, STACK_DEFAULT_ALIGNMENT SLD_ALLOC_SITE_FORWARD);
+        return(struct_inst);
+    }
+    
+    SLD_API_INLINE_STACK_TEMPLATE
+    pull_struct_top(
+        const u32 count) -> bool {
+
+        const u32  struct_size = sizeof(struct_type) * count;
+        const bool did_pull    = this->pull_top(struct_size); 
+        return(did_pull);
+    }
 };
 
 #endif //SLD_STACK_HPP
\ No newline at end of file
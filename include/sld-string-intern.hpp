@@ -0,0 +1,48 @@
+#ifndef SLD_STRING_INTERN_HPP
+#define SLD_STRING_INTERN_HPP
+
+#include "sld.hpp"
+#include "sld-arena.hpp"
+#include "sld-hash-table.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // STRING INTERN
+    //-------------------------------------------------------------------
+
+    // NOTE(SAM): every distinct string is copied into the arena once and gets a
+    // 32 bit id, so comparing interned strings is comparing ids. ids are handed
+    // out in order and never reused, the id is an index into the entries so
+    // getting the string back is one load. id 0 is always the empty string
+    constexpr u32 STRING_INTERN_ID_EMPTY   = 0;
+    constexpr u32 STRING_INTERN_INVALID_ID = 0xFFFFFFFF;
+
+    struct string_intern_t;
+    struct string_intern_entry_t;
+
+    SLD_API bool         string_intern_init       (string_intern_t&       intern, arena* arena, const u32 capacity);
+    SLD_API bool         string_intern_validate   (const string_intern_t& intern);
+    SLD_API u32          string_intern_add        (string_intern_t&       intern, const cchar* chars, const u32 length);
+    SLD_API u32          string_intern_add_cstr   (string_intern_t&       intern, const cchar* chars);
+    SLD_API u32          string_intern_find       (const string_intern_t& intern, const cchar* chars, const u32 length);
+    SLD_API const cchar* string_intern_get        (const string_intern_t& intern, const u32    id);
+    SLD_API u32          string_intern_get_length (const string_intern_t& intern, const u32    id);
+    SLD_API u32          string_intern_get_count  (const string_intern_t& intern);
+
+    struct string_intern_entry_t {
+        const cchar* chars;
+        u32          length;
+    };
+
+    // the table maps a string's hash to its id
+    struct string_intern_t {
+        arena*                 chars;
+        string_intern_entry_t* entries;
+        u32                    count;
+        u32                    capacity;
+        hash_table_t           table;
+    };
+};
+
+#endif //SLD_STRING_INTERN_HPP
@@ -3,9 +3,18 @@
 
 // TODO(SAM): platform and graphics specific stuff should be moved out of here
 
-#include <Windows.h>
+#if defined(_WIN32)
+#   include <Windows.h>
+#else
+#   include <cstddef>
+#   include <cstring>
+#endif
 
 #include <cstdint>
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
 #include <imgui.h>
 #include <imgui_impl_opengl3.h>
 #include <imgui_impl_win32.h>
@@ -27,9 +36,9 @@
 
 #ifndef assert
 #   ifdef WIN32
-#       define assert(expr) if(!expr) DebugBreak()
+#       define assert(expr) if(!(expr)) DebugBreak()
 #   else
-#       define assert(expr) if(!expr) *(int*)(NULL)=1
+#       define assert(expr) if(!(expr)) *(int*)(NULL)=1
 #   endif
 #endif
 #define nop   assert(true)
@@ -128,6 +137,49 @@ namespace sld {
     SLD_UTILITY void bit_mask_and  (u32& value,      const u32 mask)                   { (value |=  mask);                                   }
     SLD_UTILITY void bit_mask_or   (u32& value,      const u32 mask)                   { (value &= ~mask);                                   }
 
+    // index of the lowest/highest set bit, the value can't be zero
+    SLD_INLINE u32
+    bit_scan_forward(
+        const u32 value) {
+
+        assert(value != 0);
+    #if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, value);
+        return((u32)index);
+    #else
+        return((u32)__builtin_ctz(value));
+    #endif
+    }
+
+    SLD_INLINE u32
+    bit_scan_reverse(
+        const u32 value) {
+
+        assert(value != 0);
+    #if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse(&index, value);
+        return((u32)index);
+    #else
+        return((u32)(31 - __builtin_clz(value)));
+    #endif
+    }
+
+    SLD_INLINE u32
+    bit_scan_reverse_64(
+        const u64 value) {
+
+        assert(value != 0);
+    #if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return((u32)index);
+    #else
+        return((u32)(63 - __builtin_clzll(value)));
+    #endif
+    }
+
     //-------------------------------------------------------------------
     // FLAGS
     //-------------------------------------------------------------------
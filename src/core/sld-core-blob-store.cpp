@@ -0,0 +1,553 @@
+#pragma once
+
+#include "sld-blob-store.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_INTERNAL blob_store_entry_t*
+    blob_store_get_entry(
+        const blob_store_t& store,
+        const u32           id) {
+
+        blob_store_entry_t* block = store.entry_block_array[id / store.entry_per_block];
+        blob_store_entry_t* entry = &block[id % store.entry_per_block];
+        return(entry);
+    }
+
+    SLD_INTERNAL hash128_t
+    blob_store_hash(
+        const byte* data,
+        const u64   size) {
+
+        hash_table_key_t key;
+        key.data   = data;
+        key.length = size;
+
+        const hash128_t hash = hash_table_hash_key(key);
+        return(hash);
+    }
+
+    // the id whose hash matches, the bytes aren't compared
+    SLD_INTERNAL u32
+    blob_store_search(
+        const blob_store_t& store,
+        const hash128_t&    hash) {
+
+        hash_table_value_t value;
+        const bool is_found = hash_table_search_hash(store.table, hash, value);
+        const u32  id       = is_found ? *(const u32*)value.data : BLOB_STORE_INVALID_ID;
+        return(id);
+    }
+
+    // a 128 bit collision won't happen, but if it does the bytes that got
+    // there first keep the hash and the other ones can't be stored or found
+    SLD_INTERNAL bool
+    blob_store_is_match(
+        const blob_store_t& store,
+        const u32           id,
+        const byte*         data,
+        const u64           size) {
+
+        const blob_store_entry_t* entry = blob_store_get_entry(store, id);
+
+        bool is_match = true;
+        is_match &= (entry->size == size);
+        is_match &= is_match && (memcmp(&store.view.data[entry->offset], data, size) == 0);
+        return(is_match);
+    }
+
+    SLD_INTERNAL u32
+    blob_store_push_entry(
+        blob_store_t&    store,
+        const hash128_t& hash,
+        const u64        offset,
+        const u32        size) {
+
+        if (store.count == store.count_max) return(BLOB_STORE_INVALID_ID);
+
+        // the first entry of a block commits it, blocks stay if the entries are thrown away
+        const u32 id          = store.count;
+        const u32 block_index = id / store.entry_per_block;
+        if (store.entry_block_array[block_index] == NULL) {
+            void* block = block_allocator_commit(&store.entry_blocks);
+            if (!block) return(BLOB_STORE_INVALID_ID);
+            store.entry_block_array[block_index] = (blob_store_entry_t*)block;
+        }
+
+        const bool is_inserted = hash_table_insert_hash(store.table, hash, (const byte*)&id);
+        if (!is_inserted) return(BLOB_STORE_INVALID_ID);
+
+        blob_store_entry_t* entry = blob_store_get_entry(store, id);
+        entry->hash      = hash;
+        entry->offset    = offset;
+        entry->size      = size;
+        entry->ref_count = 0;
+        ++store.count;
+        return(id);
+    }
+
+    // the payload starts right after the record, the caller fills in both
+    SLD_INTERNAL blob_store_record_t*
+    blob_store_push_record(
+        blob_store_t& store,
+        const u32     kind,
+        const u64     size) {
+
+        const u64 offset      = store.header->size_used;
+        const u64 offset_next = size_align_pow_2(offset + sizeof(blob_store_record_t) + size, BLOB_STORE_RECORD_ALIGNMENT);
+        if (offset_next > store.size_capacity) return(NULL);
+
+        blob_store_record_t* record = (blob_store_record_t*)&store.view.data[offset];
+        record->size     = size;
+        record->kind     = kind;
+        record->reserved = 0;
+
+        store.header->size_used = offset_next;
+        return(record);
+    }
+
+    SLD_INTERNAL bool
+    blob_store_is_record(
+        const blob_store_t& store,
+        const u64           offset) {
+
+        const u64 size_used = store.header->size_used;
+        if (offset + sizeof(blob_store_record_t) > size_used) return(false);
+
+        const blob_store_record_t* record = (const blob_store_record_t*)&store.view.data[offset];
+        const u64                  left   = size_used - offset - sizeof(blob_store_record_t);
+
+        bool is_record = true;
+        is_record &= (record->kind == blob_store_record_kind_e_blob || record->kind == blob_store_record_kind_e_index);
+        is_record &= (record->size <= left);
+        is_record &= (record->size <= 0xFFFFFFFF);
+        return(is_record);
+    }
+
+    SLD_INTERNAL bool
+    blob_store_is_record_intact(
+        const blob_store_t& store,
+        const u64           offset) {
+
+        const blob_store_record_t* record    = (const blob_store_record_t*)&store.view.data[offset];
+        const hash128_t            hash      = blob_store_hash((const byte*)&record[1], record->size);
+        const bool                 is_intact = (hash128_compare(record->hash, hash) == 0);
+        return(is_intact);
+    }
+
+    // returns the offset just past the index, or 0 if it's no good and
+    // everything has to come from the records instead
+    SLD_INTERNAL u64
+    blob_store_load_index(
+        blob_store_t& store,
+        const u64     offset) {
+
+        bool is_index = true;
+        is_index &= blob_store_is_record(store, offset);
+        is_index &= is_index && blob_store_is_record_intact(store, offset);
+        if (!is_index) return(0);
+
+        const blob_store_record_t* record = (const blob_store_record_t*)&store.view.data[offset];
+        const u64                  count  = record->size / sizeof(blob_store_entry_t);
+
+        is_index &= (record->kind == blob_store_record_kind_e_index);
+        is_index &= (record->size % sizeof(blob_store_entry_t) == 0);
+        is_index &= (count <= store.count_max);
+        if (!is_index) return(0);
+
+        const blob_store_entry_t* index = (const blob_store_entry_t*)&record[1];
+        for (
+            u64 entry = 0;
+            entry < count;
+            ++entry) {
+
+            const u64 offset_end = index[entry].offset + index[entry].size;
+
+            bool is_entry = true;
+            is_entry &= (index[entry].offset % BLOB_STORE_RECORD_ALIGNMENT == 0);
+            is_entry &= (offset_end <= offset);
+            is_entry &= is_entry && blob_store_push_entry(store, index[entry].hash, index[entry].offset, index[entry].size) != BLOB_STORE_INVALID_ID;
+            if (!is_entry) return(0);
+        }
+
+        store.count_indexed = store.count;
+        return(size_align_pow_2(offset + sizeof(blob_store_record_t) + record->size, BLOB_STORE_RECORD_ALIGNMENT));
+    }
+
+    // walks the records from offset to the end. a blob that doesn't check out
+    // is what was being written when we last went down, the file ends there.
+    // indexes are only skipped, everything in them is in the blobs too
+    SLD_INTERNAL bool
+    blob_store_load_records(
+        blob_store_t& store,
+        const u64     offset) {
+
+        u64 offset_record = offset;
+        while (offset_record < store.header->size_used) {
+
+            const blob_store_record_t* record = (const blob_store_record_t*)&store.view.data[offset_record];
+
+            bool is_record = true;
+            is_record &= blob_store_is_record(store, offset_record);
+            is_record &= is_record && (record->kind == blob_store_record_kind_e_index || blob_store_is_record_intact(store, offset_record));
+            if (!is_record) {
+                store.header->size_used = offset_record;
+                break;
+            }
+
+            const u64 offset_payload = offset_record + sizeof(blob_store_record_t);
+            const u32 size           = (u32)record->size;
+
+            // an index, or a blob added again after its entry was lost
+            bool is_new = true;
+            is_new &= (record->kind == blob_store_record_kind_e_blob);
+            is_new &= is_new && blob_store_search(store, record->hash) == BLOB_STORE_INVALID_ID;
+
+            if (is_new && blob_store_push_entry(store, record->hash, offset_payload, size) == BLOB_STORE_INVALID_ID) {
+                return(false);
+            }
+
+            offset_record = size_align_pow_2(offset_payload + size, BLOB_STORE_RECORD_ALIGNMENT);
+        }
+        return(true);
+    }
+
+    SLD_INTERNAL void
+    blob_store_unmap(
+        blob_store_t& store) {
+
+        if (store.view.data != NULL) (void)os_file_map_unview(&store.view);
+        if (store.map       != NULL) (void)os_file_map_destroy(store.map);
+        if (store.entry_blocks.start != 0) (void)block_allocator_release_os_memory(&store.entry_blocks);
+        memset(&store, 0, sizeof(blob_store_t));
+    }
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    SLD_API bool
+    blob_store_open(
+        blob_store_t&        store,
+        arena*               arena,
+        const os_file_handle file_hnd,
+        const u64            size_capacity,
+        const u32            count_max) {
+
+        bool can_open = true;
+        can_open &= (arena         != NULL);
+        can_open &= (file_hnd      != OS_FILE_HANDLE_INVALID);
+        can_open &= (size_capacity >= sizeof(blob_store_file_header_t));
+        can_open &= (count_max     != 0);
+        if (!can_open) return(can_open);
+
+        memset(&store, 0, sizeof(blob_store_t));
+
+        const u64 file_size = os_file_get_size(file_hnd);
+        if (file_size == OS_FILE_SIZE_INVALID) return(false);
+        if (file_size != 0 && file_size < sizeof(blob_store_file_header_t)) return(false);
+
+        // the index is hashed like any other payload, so it has to fit in a u32
+        const u64 size_entries   = (u64)count_max * sizeof(blob_store_entry_t);
+        const u64 capacity_table = ((u64)count_max * 100) / HASH_TABLE_DEFAULT_LOAD_PERCENT + 1;
+        if (size_entries > 0xFFFFFFFF || capacity_table > 0xFFFFFFFF) return(false);
+
+        // never map less than the file, an existing store can only grow
+        const u64 granularity   = os_file_map_get_granularity();
+        const u64 size_file_max = (file_size > size_capacity) ? file_size : size_capacity;
+        store.size_capacity     = size_align_pow_2(size_file_max, granularity);
+
+        // the table comes out of the arena, entries out of blocks committed as they fill
+        const u64 size_table       = hash_table_memory_size((u32)capacity_table, sizeof(u32));
+        const u32 size_entry_block = (size_entries < BLOB_STORE_ENTRY_BLOCK_SIZE) ? (u32)size_entries : BLOB_STORE_ENTRY_BLOCK_SIZE;
+
+        memory_t memory_table;
+        memory_table.bytes = arena->push_bytes(size_table, alignof(hash128_t));
+        memory_table.size  = size_table;
+
+        bool is_open = true;
+        is_open &= (memory_table.bytes != NULL);
+        is_open &= is_open && hash_table_memory_init(store.table, memory_table, (u32)capacity_table, sizeof(u32));
+        is_open &= is_open && block_allocator_reserve_os_memory(&store.entry_blocks, size_entries, size_entry_block);
+        if (!is_open) {
+            blob_store_unmap(store);
+            return(is_open);
+        }
+
+        const u64 size_block_array = (u64)store.entry_blocks.block_count * sizeof(blob_store_entry_t*);
+        store.entry_block_array    = (blob_store_entry_t**)arena->push_bytes(size_block_array, alignof(blob_store_entry_t*));
+        store.entry_per_block      = store.entry_blocks.block_size / sizeof(blob_store_entry_t);
+        store.count_max            = count_max;
+        store.file                 = file_hnd;
+
+        is_open &= (store.entry_block_array != NULL);
+        if (is_open) {
+            memset(store.entry_block_array, 0, size_block_array);
+            store.map = os_file_map_create_writable(file_hnd, store.size_capacity);
+        }
+        is_open &= (store.map != NULL);
+        is_open &= is_open && os_file_map_view_writable(store.map, 0, store.size_capacity, &store.view);
+        if (!is_open) {
+            blob_store_unmap(store);
+            return(is_open);
+        }
+
+        // a new file is all zeros past its old end, so only the header needs writing
+        store.header = (blob_store_file_header_t*)store.view.data;
+        if (file_size == 0) {
+            store.header->magic        = BLOB_STORE_MAGIC;
+            store.header->version      = BLOB_STORE_VERSION;
+            store.header->size_used    = sizeof(blob_store_file_header_t);
+            store.header->index_offset = 0;
+            return(true);
+        }
+
+        is_open &= (store.header->magic     == BLOB_STORE_MAGIC);
+        is_open &= (store.header->version   == BLOB_STORE_VERSION);
+        is_open &= (store.header->size_used >= sizeof(blob_store_file_header_t));
+        is_open &= (store.header->size_used <= file_size);
+        if (!is_open) {
+            blob_store_unmap(store);
+            return(is_open);
+        }
+
+        // a bad index leaves entries behind, start over and read every record
+        u64 offset_records = (store.header->index_offset != 0)
+            ? blob_store_load_index(store, store.header->index_offset)
+            : 0;
+        if (offset_records == 0) {
+            is_open &= hash_table_reset(store.table);
+            store.count         = 0;
+            store.count_indexed = 0;
+            offset_records      = sizeof(blob_store_file_header_t);
+        }
+
+        is_open &= is_open && blob_store_load_records(store, offset_records);
+        if (!is_open) blob_store_unmap(store);
+        return(is_open);
+    }
+
+    SLD_API bool
+    blob_store_close(
+        blob_store_t& store) {
+
+        const bool is_valid = blob_store_validate(store);
+        if (!is_valid) return(is_valid);
+
+        const bool is_flushed = blob_store_flush(store);
+        blob_store_unmap(store);
+        return(is_flushed);
+    }
+
+    SLD_API bool
+    blob_store_validate(
+        const blob_store_t& store) {
+
+        bool is_valid = true;
+        is_valid &= (store.file              != OS_FILE_HANDLE_INVALID);
+        is_valid &= (store.map               != NULL);
+        is_valid &= (store.view.data         != NULL);
+        is_valid &= (store.header            != NULL);
+        is_valid &= (store.entry_block_array != NULL);
+        is_valid &= (store.entry_per_block   != 0);
+        is_valid &= (store.count             <= store.count_max);
+        is_valid &= (store.count_indexed     <= store.count);
+        is_valid &= is_valid && (store.header->size_used <= store.size_capacity);
+        is_valid &= block_allocator_validate(&store.entry_blocks);
+        is_valid &= hash_table_validate(store.table);
+        return(is_valid);
+    }
+
+    SLD_API bool
+    blob_store_flush(
+        blob_store_t& store) {
+
+        assert(blob_store_validate(store));
+
+        // a new index only when there's something it doesn't have
+        if (store.count != store.count_indexed) {
+
+            const u64            size   = (u64)store.count * sizeof(blob_store_entry_t);
+            const u64            offset = store.header->size_used;
+            blob_store_record_t* record = blob_store_push_record(store, blob_store_record_kind_e_index, size);
+            if (!record) return(false);
+
+            blob_store_entry_t* index = (blob_store_entry_t*)&record[1];
+            for (
+                u32 id = 0;
+                id < store.count;
+                ++id) {
+
+                index[id]           = *blob_store_get_entry(store, id);
+                index[id].ref_count = 0;
+            }
+
+            record->hash               = blob_store_hash((const byte*)index, size);
+            store.header->index_offset = offset;
+            store.count_indexed        = store.count;
+        }
+
+        const bool is_flushed = os_file_map_flush(&store.view);
+        return(is_flushed);
+    }
+
+    SLD_API u32
+    blob_store_add(
+        blob_store_t& store,
+        const byte*   data,
+        const u64     size) {
+
+        assert(blob_store_validate(store));
+
+        bool can_add = true;
+        can_add &= (data != NULL);
+        can_add &= (size != 0);
+        can_add &= (size <= 0xFFFFFFFF);
+        if (!can_add) return(BLOB_STORE_INVALID_ID);
+
+        // a hash that's taken by other bytes can't be added
+        const hash128_t hash = blob_store_hash(data, size);
+        const u32       id   = blob_store_search(store, hash);
+        if (id != BLOB_STORE_INVALID_ID) {
+            if (!blob_store_is_match(store, id, data, size)) return(BLOB_STORE_INVALID_ID);
+            ++blob_store_get_entry(store, id)->ref_count;
+            return(id);
+        }
+        if (store.count == store.count_max) return(BLOB_STORE_INVALID_ID);
+
+        const u64            offset = store.header->size_used;
+        blob_store_record_t* record = blob_store_push_record(store, blob_store_record_kind_e_blob, size);
+        if (!record) return(BLOB_STORE_INVALID_ID);
+
+        record->hash = hash;
+        memcpy(&record[1], data, size);
+
+        // give the space back if the entry can't be made
+        const u32 id_new = blob_store_push_entry(store, hash, offset + sizeof(blob_store_record_t), (u32)size);
+        if (id_new == BLOB_STORE_INVALID_ID) {
+            store.header->size_used = offset;
+            return(id_new);
+        }
+
+        blob_store_get_entry(store, id_new)->ref_count = 1;
+        return(id_new);
+    }
+
+    SLD_API u32
+    blob_store_find(
+        const blob_store_t& store,
+        const byte*         data,
+        const u64           size) {
+
+        assert(blob_store_validate(store));
+
+        bool can_find = true;
+        can_find &= (data != NULL);
+        can_find &= (size != 0);
+        can_find &= (size <= 0xFFFFFFFF);
+        if (!can_find) return(BLOB_STORE_INVALID_ID);
+
+        const hash128_t hash     = blob_store_hash(data, size);
+        const u32       id       = blob_store_search(store, hash);
+        const bool      is_match = (id != BLOB_STORE_INVALID_ID) && blob_store_is_match(store, id, data, size);
+        return(is_match ? id : BLOB_STORE_INVALID_ID);
+    }
+
+    SLD_API u32
+    blob_store_find_hash(
+        const blob_store_t& store,
+        const hash128_t&    hash) {
+
+        assert(blob_store_validate(store));
+
+        hash_table_value_t value;
+        const bool is_found = hash_table_search_hash(store.table, hash, value);
+        const u32  id       = is_found ? *(const u32*)value.data : BLOB_STORE_INVALID_ID;
+        return(id);
+    }
+
+    SLD_API bool
+    blob_store_acquire(
+        blob_store_t& store,
+        const u32     id) {
+
+        const bool is_valid = (id < store.count);
+        if (is_valid) ++blob_store_get_entry(store, id)->ref_count;
+        return(is_valid);
+    }
+
+    SLD_API bool
+    blob_store_release(
+        blob_store_t& store,
+        const u32     id) {
+
+        if (id >= store.count) return(false);
+
+        blob_store_entry_t* entry      = blob_store_get_entry(store, id);
+        const bool          is_counted = (entry->ref_count != 0);
+        if (is_counted) --entry->ref_count;
+        return(is_counted);
+    }
+
+    SLD_API const byte*
+    blob_store_get_data(
+        const blob_store_t& store,
+        const u32           id) {
+
+        const byte* data = (id < store.count)
+            ? &store.view.data[blob_store_get_entry(store, id)->offset]
+            : NULL;
+        return(data);
+    }
+
+    SLD_API u32
+    blob_store_get_size(
+        const blob_store_t& store,
+        const u32           id) {
+
+        const u32 size = (id < store.count)
+            ? blob_store_get_entry(store, id)->size
+            : 0;
+        return(size);
+    }
+
+    SLD_API bool
+    blob_store_get_hash(
+        const blob_store_t& store,
+        const u32           id,
+        hash128_t&          hash) {
+
+        const bool is_valid = (id < store.count);
+        if (is_valid) hash = blob_store_get_entry(store, id)->hash;
+        return(is_valid);
+    }
+
+    SLD_API u32
+    blob_store_get_ref_count(
+        const blob_store_t& store,
+        const u32           id) {
+
+        const u32 ref_count = (id < store.count)
+            ? blob_store_get_entry(store, id)->ref_count
+            : 0;
+        return(ref_count);
+    }
+
+    SLD_API u32
+    blob_store_get_count(
+        const blob_store_t& store) {
+
+        return(store.count);
+    }
+
+    SLD_API u64
+    blob_store_get_size_used(
+        const blob_store_t& store) {
+
+        return(store.header ? store.header->size_used : 0);
+    }
+};
@@ -1,223 +1,825 @@
 #pragma once
 
+#include <new>
+
 #include "sld-hash-table.hpp"
+#include "sld-simd.hpp"
 
 namespace sld {
 
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    struct hash_table_layout_t {
+        u64 group_count;
+        u64 slot_count;
+        u64 offset_value;
+        u64 offset_control;
+        u64 offset_overflow;
+        u64 size_total;
+    };
+
     SLD_INTERNAL bool
+    hash_table_layout(
+        const u32            capacity,
+        const u32            stride,
+        hash_table_layout_t& layout) {
+
+        if (capacity == 0) return(false);
+
+        // whole groups, and a power of two of them so the probe can wrap with a mask
+        const u64 group_count = size_round_up_pow2((capacity + HASH_TABLE_GROUP_SIZE - 1) / HASH_TABLE_GROUP_SIZE);
+        const u64 slot_count  = (group_count * HASH_TABLE_GROUP_SIZE);
+        if (slot_count > 0xFFFFFFFF) return(false);
+
+        // hashes go first so they keep the alignment of the memory
+        const u64 size_hash     = (slot_count  * sizeof(hash128_t));
+        const u64 size_value    = (slot_count  * stride);
+        const u64 size_control  = (slot_count  * sizeof(u8));
+        const u64 size_overflow = (group_count * sizeof(u8));
+
+        layout.group_count     = group_count;
+        layout.slot_count      = slot_count;
+        layout.offset_value    = size_hash;
+        layout.offset_control  = layout.offset_value   + size_value;
+        layout.offset_overflow = layout.offset_control + size_control;
+        layout.size_total      = layout.offset_overflow + size_overflow;
+        return(true);
+    }
+
+    SLD_INTERNAL void
+    hash_table_clear(
+        hash_table_t& hash_table) {
+
+        const u32 group_count = (hash_table.group_mask + 1);
+        memset(hash_table.array.control,  HASH_TABLE_CONTROL_EMPTY, hash_table.capacity);
+        memset(hash_table.array.overflow, 0,                        group_count);
+        hash_table.count = 0;
+    }
+
+    SLD_INLINE u32
+    hash_table_hash_group(
+        const hash_table_t& hash_table,
+        const hash128_t&    hash) {
+
+        const u32 group = ((u32)hash.val.as_u64[0] & hash_table.group_mask);
+        return(group);
+    }
+
+    SLD_INLINE u8
+    hash_table_hash_tag(
+        const hash128_t& hash) {
+
+        // the top 7 bits of the other half, so the tag and the group are independent
+        const u8 tag = (u8)(hash.val.as_u64[1] >> 57);
+        return(tag);
+    }
+
+    SLD_INLINE bool
+    hash_table_hash_is_equal(
+        const hash128_t& hash_a,
+        const hash128_t& hash_b) {
+
+        const bool is_equal = (
+            hash_a.val.as_u64[0] == hash_b.val.as_u64[0] &&
+            hash_a.val.as_u64[1] == hash_b.val.as_u64[1]
+        );
+        return(is_equal);
+    }
+
+    SLD_INLINE u32
+    hash_table_group_match(
+        const u8* control,
+        const u8  tag) {
+
+        const __m128i reg_control = _mm_loadu_si128((const __m128i*)control);
+        const __m128i reg_tag     = _mm_set1_epi8((char)tag);
+        const u32     mask        = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(reg_control, reg_tag));
+        return(mask);
+    }
+
+    SLD_INLINE u32
+    hash_table_group_match_empty(
+        const u8* control) {
+
+        // empty is the only control byte with the high bit set
+        const __m128i reg_control = _mm_loadu_si128((const __m128i*)control);
+        const u32     mask        = (u32)_mm_movemask_epi8(reg_control);
+        return(mask);
+    }
+
+    SLD_INTERNAL u32
+    hash_table_find_slot(
+        const hash_table_t& hash_table,
+        const hash128_t&    hash) {
+
+        const u8 tag   = hash_table_hash_tag   (hash);
+        u32      group = hash_table_hash_group (hash_table, hash);
+
+        // triangular steps over a power of two group count visit every group once
+        for (
+            u32 step = 1;
+            step <= (hash_table.group_mask + 1);
+            ++step) {
+
+            const u32 slot_first = (group * HASH_TABLE_GROUP_SIZE);
+            u32       mask       = hash_table_group_match(&hash_table.array.control[slot_first], tag);
+            while (mask != 0) {
+
+                const u32 slot = slot_first + bit_scan_forward(mask);
+                if (hash_table_hash_is_equal(hash_table.array.hash[slot], hash)) return(slot);
+                mask &= (mask - 1);
+            }
+
+            // nothing was ever pushed past this group, so the key can't be further on
+            if (hash_table.array.overflow[group] == 0) break;
+            group = (group + step) & hash_table.group_mask;
+        }
+        return(HASH_TABLE_INVALID_INDEX);
+    }
+
+    SLD_INTERNAL void
+    hash_table_overflow_release(
+        hash_table_t&    hash_table,
+        const hash128_t& hash,
+        const u32        slot) {
+
+        // walk the probe again up to the slot's group, every group before it was
+        // counted when the entry went in
+        const u32 group_slot = (slot / HASH_TABLE_GROUP_SIZE);
+        u32       group      = hash_table_hash_group(hash_table, hash);
+        for (
+            u32 step = 1;
+            group != group_slot;
+            ++step) {
+
+            u8& overflow = hash_table.array.overflow[group];
+
+            // a saturated count can't be trusted anymore, it stays saturated
+            if (overflow != HASH_TABLE_OVERFLOW_MAX) --overflow;
+            group = (group + step) & hash_table.group_mask;
+        }
+    }
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    SLD_API const u64
+    hash_table_memory_size(
+        const u32 capacity,
+        const u32 stride) {
+
+        hash_table_layout_t layout;
+        const u64 size_total = hash_table_layout(capacity, stride, layout)
+            ? layout.size_total
+            : 0;
+        return(size_total);
+    }
+
+    SLD_API bool
+    hash_table_memory_init(
+        hash_table_t&   hash_table,
+        const memory_t& memory,
+        const u32       capacity,
+        const u32       stride,
+        const u32       load_percent) {
+
+        hash_table_layout_t layout;
+        const bool has_layout = hash_table_layout(capacity, stride, layout);
+        if (!has_layout) {
+            hash_table.error.val = hash_table_error_e_invalid_table;
+            return(false);
+        }
+
+        bool can_init = true;
+        can_init &= (memory.start != 0);
+        can_init &= (memory.size  >= layout.size_total);
+        can_init &= ((memory.start & (alignof(hash128_t) - 1)) == 0);
+        if (!can_init) {
+            hash_table.error.val = hash_table_error_e_not_enough_memory;
+            return(can_init);
+        }
+
+        // the load factor is clamped, at 100 the overflow counts still keep lookups
+        // correct but a full table probes every group on a miss
+        const u32 load_clamped = (load_percent == 0) ? 1 : (load_percent > 100) ? 100 : load_percent;
+
+        hash_table.capacity       = (u32)layout.slot_count;
+        hash_table.stride         = stride;
+        hash_table.count          = 0;
+        hash_table.count_max      = (u32)((layout.slot_count * load_clamped) / 100);
+        hash_table.group_mask     = (u32)(layout.group_count - 1);
+        hash_table.load_percent   = load_clamped;
+        hash_table.array.hash     = (hash128_t*)(memory.start);
+        hash_table.array.value    =      (byte*)(memory.start + layout.offset_value);
+        hash_table.array.control  =        (u8*)(memory.start + layout.offset_control);
+        hash_table.array.overflow =        (u8*)(memory.start + layout.offset_overflow);
+        hash_table.error.val      = hash_table_error_e_success;
+
+        hash_table_clear(hash_table);
+        return(true);
+    }
+
+    SLD_API bool
     hash_table_validate(
         const hash_table_t& hash_table) {
 
         bool is_valid = true;
 
-        is_valid &= (hash_table.capacity    != 0);
-        is_valid &= (hash_table.stride      != 0);
-        is_valid &= (hash_table.count       <= hash_table.capacity);
-        is_valid &= (hash_table.array.hash  != NULL);
-        is_valid &= (hash_table.array.value != NULL);
+        is_valid &= (hash_table.capacity       != 0);
+        is_valid &= (hash_table.count          <= hash_table.count_max);
+        is_valid &= (hash_table.count_max      <= hash_table.capacity);
+        is_valid &= (hash_table.capacity       == ((hash_table.group_mask + 1) * HASH_TABLE_GROUP_SIZE));
+        is_valid &= (hash_table.array.hash     != NULL);
+        is_valid &= (hash_table.array.value    != NULL);
+        is_valid &= (hash_table.array.control  != NULL);
+        is_valid &= (hash_table.array.overflow != NULL);
 
         return(is_valid);
     }
 
-    SLD_INTERNAL bool
+    SLD_API bool
     hash_table_validate_key(
-        const hash_table_t&     hash_table,
         const hash_table_key_t& key) {
 
         bool is_valid = true;
-        
+
         is_valid &= (key.data   != NULL);
         is_valid &= (key.length != 0);
-        
+        is_valid &= (key.length <= 0xFFFFFFFF);
+
         return(is_valid);
     }
 
-    SLD_INTERNAL bool
+    SLD_API bool
     hash_table_validate_value(
-        const hash_table_t&         hash_table,
-        const hash_table_value_t&   value) {
-
-        const u32  size_hash  = (hash_table.capacity  * sizeof(hash_t));
-        const u32  size_value = (hash_table.capacity  * hash_table.stride);
-        const u32  size_total = (size_hash + size_value);
-        const addr data_start = (addr)hash_table.array.hash + size_hash;
-        const addr data_end   = (addr)hash_table.array.hash + size_total;
+        const hash_table_t&       hash_table,
+        const hash_table_value_t& value) {
+
+        const u64  size_value = ((u64)hash_table.capacity * hash_table.stride);
+        const addr data_start = (addr)hash_table.array.value;
+        const addr data_end   = (addr)hash_table.array.value + size_value;
         const addr data_value = (addr)value.data;
 
         bool is_valid = true;
-        
-        is_valid &= (value.index < hash_table.count);
+
+        is_valid &= (value.index < hash_table.capacity);
+        is_valid &= is_valid && (hash_table.array.control[value.index] != HASH_TABLE_CONTROL_EMPTY);
         is_valid &= (data_value >= data_start);
-        is_valid &= (data_value  < data_end);
-        
+        is_valid &= (data_value + hash_table.stride <= data_end);
+
         return(is_valid);
     }
 
-    SLD_INTERNAL const u32
-    hash_table_memory_size(
-        const hash_table_t& hash_table) {
+    SLD_API bool
+    hash_table_reset(
+        hash_table_t& hash_table) {
 
-        const u32 size_hash  = (hash_table.capacity  * sizeof(hash_t));
-        const u32 size_value = (hash_table.capacity  * hash_table.stride);
-        const u32 size_total = (size_hash + size_value);
+        const bool is_valid = hash_table_validate(hash_table);
 
-        return(size_total);
+        if (is_valid) {
+            hash_table_clear(hash_table);
+        }
+
+        return(is_valid);
     }
-    
-    SLD_INTERNAL bool
-    hash_table_memory_init(
+
+    SLD_API bool
+    hash_table_rehash(
         hash_table_t&   hash_table,
-        const memory_t& memory) {
+        const memory_t& memory,
+        const u32       capacity) {
 
-        const u32 size_hash  = (hash_table.capacity  * sizeof(hash_t));
-        const u32 size_value = (hash_table.capacity  * hash_table.stride);
-        const u32 size_total = (size_hash + size_value);
+        // moves every entry into a table on the new memory, the old memory
+        // is untouched and belongs to the caller again once this returns
+        const bool is_valid = hash_table_validate(hash_table);
+        if (!is_valid) {
+            hash_table.error.val = hash_table_error_e_invalid_table;
+            return(is_valid);
+        }
 
-        bool can_init = true;
-        can_init &= (memory.size  >= size_needed);
-        can_init &= (memory.start != 0);
-        if (!can_init) return(can_init);
+        hash_table_t hash_table_new;
+        const bool is_init = hash_table_memory_init(
+            hash_table_new,
+            memory,
+            capacity,
+            hash_table.stride,
+            hash_table.load_percent
+        );
+        if (!is_init) {
+            hash_table.error = hash_table_new.error;
+            return(is_init);
+        }
+        if (hash_table_new.count_max < hash_table.count) {
+            hash_table.error.val = hash_table_error_e_max_count;
+            return(false);
+        }
+
+        for (
+            u32 slot = 0;
+            slot < hash_table.capacity;
+            ++slot) {
 
-        hash_table.count       = 0;
-        hash_table.array.hash  = (hash_t*)(memory.start);
-        hash_table.array.value =   (byte*)(memory.start + size_hash);
+            if (hash_table.array.control[slot] == HASH_TABLE_CONTROL_EMPTY) continue;
+
+            const byte* value = &hash_table.array.value[(u64)slot * hash_table.stride];
+            (void)hash_table_insert_hash(hash_table_new, hash_table.array.hash[slot], value);
+        }
+
+        hash_table = hash_table_new;
+        return(true);
     }
-    
-    SLD_INTERNAL bool
-    hash_table_reset(
-        hash_table_t& hash_table) {
 
-        const bool is_valid = hash_table_validate(hash_table);
-        
-        if (is_valid) {
-            hash_table.count = 0;
+    SLD_API hash128_t
+    hash_table_hash_key(
+        const hash_table_key_t& key) {
+
+        const hash128_seed_t& seed = *(const hash128_seed_t*)MeowDefaultSeed;
+        const hash128_t       hash = hash128_data(seed, key.data, (u32)key.length);
+        return(hash);
+    }
+
+    SLD_API bool
+    hash_table_insert(
+        hash_table_t&           hash_table,
+        const hash_table_key_t& key,
+        const byte*             value) {
+
+        const bool valid_key = hash_table_validate_key(key);
+        if (!valid_key) { hash_table.error.val = hash_table_error_e_invalid_key; return(valid_key); }
+
+        const hash128_t hash        = hash_table_hash_key(key);
+        const bool      is_inserted = hash_table_insert_hash(hash_table, hash, value);
+        return(is_inserted);
+    }
+
+    SLD_API bool
+    hash_table_insert_hash(
+        hash_table_t&    hash_table,
+        const hash128_t& hash,
+        const byte*      value) {
+
+        const bool valid_table = hash_table_validate(hash_table);
+        const bool valid_value = (value != NULL || hash_table.stride == 0);
+        const bool valid_count = valid_table && (hash_table.count < hash_table.count_max);
+        const bool is_unique   = valid_table && (hash_table_find_slot(hash_table, hash) == HASH_TABLE_INVALID_INDEX);
+
+        if (!valid_table) { hash_table.error.val = hash_table_error_e_invalid_table; return(false); }
+        if (!valid_value) { hash_table.error.val = hash_table_error_e_invalid_value; return(false); }
+        if (!valid_count) { hash_table.error.val = hash_table_error_e_max_count;     return(false); }
+        if (!is_unique)   { hash_table.error.val = hash_table_error_e_key_exists;    return(false); }
+
+        // the first group on the probe with room takes it, every full
+        // group on the way gets its overflow count bumped
+        u32 group = hash_table_hash_group(hash_table, hash);
+        u32 slot  = HASH_TABLE_INVALID_INDEX;
+        for (
+            u32 step = 1;
+            slot == HASH_TABLE_INVALID_INDEX;
+            ++step) {
+
+            const u32 slot_first = (group * HASH_TABLE_GROUP_SIZE);
+            const u32 mask_empty = hash_table_group_match_empty(&hash_table.array.control[slot_first]);
+            if (mask_empty != 0) {
+                slot = slot_first + bit_scan_forward(mask_empty);
+                break;
+            }
+
+            u8& overflow = hash_table.array.overflow[group];
+            if (overflow != HASH_TABLE_OVERFLOW_MAX) ++overflow;
+            group = (group + step) & hash_table.group_mask;
         }
 
-        return(is_valid);
+        hash_table.array.control [slot] = hash_table_hash_tag(hash);
+        hash_table.array.hash    [slot] = hash;
+        if (hash_table.stride != 0) {
+            byte* slot_value = &hash_table.array.value[(u64)slot * hash_table.stride];
+            memcpy(slot_value, value, hash_table.stride);
+        }
+
+        ++hash_table.count;
+        hash_table.error.val = hash_table_error_e_success;
+        return(true);
     }
-    
-    SLD_INTERNAL bool
+
+    SLD_API bool
     hash_table_remove(
         hash_table_t&           hash_table,
         const hash_table_key_t& key) {
 
+        const bool valid_key = hash_table_validate_key(key);
+        if (!valid_key) { hash_table.error.val = hash_table_error_e_invalid_key; return(valid_key); }
+
+        const hash128_t hash       = hash_table_hash_key(key);
+        const bool      is_removed = hash_table_remove_hash(hash_table, hash);
+        return(is_removed);
     }
-    
-    SLD_INTERNAL bool
+
+    SLD_API bool
+    hash_table_remove_hash(
+        hash_table_t&    hash_table,
+        const hash128_t& hash) {
+
+        const bool valid_table = hash_table_validate(hash_table);
+        if (!valid_table) { hash_table.error.val = hash_table_error_e_invalid_table; return(valid_table); }
+
+        const u32 slot = hash_table_find_slot(hash_table, hash);
+        if (slot == HASH_TABLE_INVALID_INDEX) { hash_table.error.val = hash_table_error_e_key_not_found; return(false); }
+
+        const bool is_removed = hash_table_remove_at(hash_table, slot);
+        return(is_removed);
+    }
+
+    SLD_API bool
     hash_table_remove_at(
         hash_table_t& hash_table,
         const u32     index) {
 
-    }
-    
-    SLD_INTERNAL byte*
-    hash_table_insert(
-        hash_table_t&     hash_table,
-        hash_table_key_t& key) {
-
-        byte*      value       = NULL;
-        const u32  index       = hash_table.count; 
-        const bool valid_table = hash_table_validate     (hash_table);
-        const bool valid_key   = hash_table_validate_key (hash_table, key);
-        const bool valid_count = (hash_table.count < hash_table.capacity); 
-        const bool valid_hash  = hash_data(key.data, key.length, hash_table.array.hash[index]);
-        
-        if (!valid_table) { hash_table.error.val = hash_table_error_e_invalid_table; return(value); }
-        if (!valid_key)   { hash_table.error.val = hash_table_error_e_invalid_key;   return(value); }
-        if (!valid_count) { hash_table.error.val = hash_table_error_e_max_count;     return(value); }
-        if (!valid_hash)  { hash_table.error.val = hash_table_error_e_hash_failed;   return(value); }
-
-        ++hash_table.count;
-        const u32 offset =  hash_table.stride * index;
-        value            = &hash_table.array.value[offset];
-        return(value);
-    }
-    
-    SLD_INTERNAL byte*
-    hash_table_insert_at(
-        hash_table_t&     hash_table,
-        hash_table_key_t& key,
-        const u32         index) {
-
-        byte*      value       = NULL;
-        const bool valid_table = hash_table_validate     (hash_table);
-        const bool valid_key   = hash_table_validate_key (hash_table, key);
-        const bool valid_count = (hash_table.count < hash_table.capacity); 
-        const bool valid_hash  = hash_data(key.data, key.length, hash_table.array.hash[index]);
-        const bool valid_index = (index <= hash_table.count);
-
-        if (!valid_table) { hash_table.error.val = hash_table_error_e_invalid_table;       return(value); }
-        if (!valid_key)   { hash_table.error.val = hash_table_error_e_invalid_key;         return(value); }
-        if (!valid_count) { hash_table.error.val = hash_table_error_e_max_count;           return(value); }
-        if (!valid_hash)  { hash_table.error.val = hash_table_error_e_hash_failed;         return(value); }
-        if (!valid_index) { hash_table.error.val = hash_table_error_e_index_out_of_bounds; return(value); }
+        const bool valid_table = hash_table_validate(hash_table);
+        const bool valid_index = valid_table && (index < hash_table.capacity) && (hash_table.array.control[index] != HASH_TABLE_CONTROL_EMPTY);
 
-        ++hash_table.count;
-        
-        const u32 offset_src =  hash_table.stride * index;
-        const u32 offset_dst =  hash_table.stride + offset_src;
-        const u32 copy_size  =  hash_table.count  - index;  
-        const byte*      src = &hash_table.array.value[offset_src];
-        byte*            dst = &hash_table.array.value[offset_dst];
+        if (!valid_table) { hash_table.error.val = hash_table_error_e_invalid_table;       return(false); }
+        if (!valid_index) { hash_table.error.val = hash_table_error_e_index_out_of_bounds; return(false); }
 
-        (void)memory_copy(dst, src, copy_size);
+        hash_table_overflow_release(hash_table, hash_table.array.hash[index], index);
+        hash_table.array.control[index] = HASH_TABLE_CONTROL_EMPTY;
 
-        return(src);
+        --hash_table.count;
+        hash_table.error.val = hash_table_error_e_success;
+        return(true);
     }
-    
-    SLD_INTERNAL bool
+
+    SLD_API bool
     hash_table_search(
         const hash_table_t&     hash_table,
         const hash_table_key_t& key,
-        u32&                    index) {
+        hash_table_value_t&     value) {
 
-        bool is_valid = true; 
-        is_valid &= hash_table_validate     (hash_table);
-        is_valid &= hash_table_validate_key (hash_table, key);
-        if (!is_valid) return(is_valid);
+        const bool valid_key = hash_table_validate_key(key);
+        if (!valid_key) return(valid_key);
 
-        const hash_t key_hash = hash_data(key.data, key.length);
-        const bool is_found   = hash_search(
-            hash_table.count,      // number of values
-            key_hash,              // hashed key
-            hash_table.array.hash, // stored hashes
-            value.index);          // result index
+        const hash128_t hash     = hash_table_hash_key(key);
+        const bool      is_found = hash_table_search_hash(hash_table, hash, value);
+        return(is_found);
+    }
 
+    SLD_API bool
+    hash_table_search_hash(
+        const hash_table_t& hash_table,
+        const hash128_t&    hash,
+        hash_table_value_t& value) {
+
+        const bool is_valid = hash_table_validate(hash_table);
+        if (!is_valid) return(is_valid);
+
+        const u32  slot     = hash_table_find_slot(hash_table, hash);
+        const bool is_found = (slot != HASH_TABLE_INVALID_INDEX);
+        if (is_found) {
+            value.index = slot;
+            value.data  = &hash_table.array.value[(u64)slot * hash_table.stride];
+        }
         return(is_found);
     }
-    
-    SLD_INTERNAL bool
+
+    SLD_API bool
     hash_table_get_hash_at(
         const hash_table_t& hash_table,
         const u32           index,
-        hash_t&             hash) {
+        hash128_t&          hash) {
 
-        bool is_valid = true; 
+        // indices are slots, empty slots are skipped by returning false
+        bool is_valid = true;
         is_valid &= hash_table_validate(hash_table);
-        is_valid &= (index < hash_table.count); 
-        
+        is_valid &= (index < hash_table.capacity);
+        is_valid &= is_valid && (hash_table.array.control[index] != HASH_TABLE_CONTROL_EMPTY);
+
         if (is_valid) {
             hash = hash_table.array.hash[index];
         }
 
         return(is_valid);
     }
-    
-    SLD_INTERNAL bool
+
+    SLD_API bool
     hash_table_get_value_at(
         const hash_table_t& hash_table,
+        const u32           index,
         hash_table_value_t& value) {
 
-        bool is_valid = true; 
+        bool is_valid = true;
         is_valid &= hash_table_validate(hash_table);
-        is_valid &= (value.index < hash_table.count); 
-        
+        is_valid &= (index < hash_table.capacity);
+        is_valid &= is_valid && (hash_table.array.control[index] != HASH_TABLE_CONTROL_EMPTY);
+
         if (is_valid) {
+            value.index = index;
+            value.data  = &hash_table.array.value[(u64)index * hash_table.stride];
+        }
 
-            const u32 offset =  hash_table.stride * value.index; 
-            value.data       = &hash_table.array.value[offset];
+        return(is_valid);
+    }
+
+    //-------------------------------------------------------------------
+    // SHARDED INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_INTERNAL u64
+    hash_table_sharded_shard_size(
+        const u32 shard_count,
+        const u32 capacity,
+        const u32 stride) {
+
+        // each shard's table starts on its own cache line
+        const u32 capacity_shard = (capacity + shard_count - 1) / shard_count;
+        const u64 size_table     = hash_table_memory_size(capacity_shard, stride);
+        const u64 size_shard     = size_align_pow_2(size_table, alignof(hash_table_shard_t));
+        return(size_shard);
+    }
+
+    SLD_INLINE hash_table_shard_t&
+    hash_table_sharded_get_shard(
+        const hash_table_sharded_t& sharded,
+        const hash128_t&            hash) {
+
+        // bits the table doesn't use for the group or the tag
+        const u32           shard_index = ((u32)(hash.val.as_u64[1] >> 32) & sharded.shard_mask);
+        hash_table_shard_t& shard       = sharded.shards[shard_index];
+        return(shard);
+    }
+
+    SLD_INTERNAL u32
+    hash_table_shard_write_begin(
+        hash_table_shard_t& shard) {
+
+        // writers take the shard by moving the sequence from even to odd
+        u32 sequence = shard.sequence.load(std::memory_order_relaxed);
+        for (;;) {
+            if ((sequence & 1) == 0) {
+                const bool is_locked = shard.sequence.compare_exchange_weak(
+                    sequence,
+                    sequence + 1,
+                    std::memory_order_acquire,
+                    std::memory_order_relaxed
+                );
+                if (is_locked) break;
+            }
+            else {
+                _mm_pause();
+                sequence = shard.sequence.load(std::memory_order_relaxed);
+            }
+        }
+
+        // keep the table writes from moving above the sequence becoming odd
+        std::atomic_thread_fence(std::memory_order_release);
+        return(sequence + 1);
+    }
+
+    SLD_INTERNAL void
+    hash_table_shard_write_end(
+        hash_table_shard_t& shard,
+        const u32           sequence) {
+
+        shard.sequence.store(sequence + 1, std::memory_order_release);
+    }
+
+    //-------------------------------------------------------------------
+    // SHARDED API
+    //-------------------------------------------------------------------
+
+    SLD_API const u64
+    hash_table_sharded_memory_size(
+        const u32 shard_count,
+        const u32 capacity,
+        const u32 stride) {
+
+        bool is_valid = true;
+        is_valid &= size_is_pow_2(shard_count);
+        is_valid &= (shard_count <= HASH_TABLE_SHARD_COUNT_MAX);
+        is_valid &= (capacity    != 0);
+        if (!is_valid) return(0);
+
+        const u64 size_shards = ((u64)shard_count * sizeof(hash_table_shard_t));
+        const u64 size_tables = ((u64)shard_count * hash_table_sharded_shard_size(shard_count, capacity, stride));
+        const u64 size_total  = (size_shards + size_tables);
+        return(size_total);
+    }
+
+    SLD_API bool
+    hash_table_sharded_memory_init(
+        hash_table_sharded_t& sharded,
+        const memory_t&       memory,
+        const u32             shard_count,
+        const u32             capacity,
+        const u32             stride,
+        const u32             load_percent) {
+
+        // capacity is the total, it's split evenly across the shards
+        const u64 size_total = hash_table_sharded_memory_size(shard_count, capacity, stride);
+
+        bool can_init = true;
+        can_init &= (size_total   != 0);
+        can_init &= (memory.start != 0);
+        can_init &= (memory.size  >= size_total);
+        can_init &= ((memory.start & (alignof(hash_table_shard_t) - 1)) == 0);
+        if (!can_init) return(can_init);
+
+        const u32 capacity_shard = (capacity + shard_count - 1) / shard_count;
+        const u64 size_shard     = hash_table_sharded_shard_size(shard_count, capacity, stride);
+        const u64 size_shards    = ((u64)shard_count * sizeof(hash_table_shard_t));
+
+        sharded.shard_count = shard_count;
+        sharded.shard_mask  = (shard_count - 1);
+        sharded.stride      = stride;
+        sharded.shards      = (hash_table_shard_t*)memory.start;
+
+        for (
+            u32 shard_index = 0;
+            shard_index < shard_count;
+            ++shard_index) {
+
+            hash_table_shard_t* shard = new (&sharded.shards[shard_index]) hash_table_shard_t;
+            shard->sequence.store(0, std::memory_order_relaxed);
+
+            memory_t memory_table;
+            memory_table.start = memory.start + size_shards + (shard_index * size_shard);
+            memory_table.size  = size_shard;
+
+            const bool is_init = hash_table_memory_init(
+                shard->table,
+                memory_table,
+                capacity_shard,
+                stride,
+                load_percent
+            );
+            if (!is_init) return(is_init);
         }
+        return(true);
+    }
+
+    SLD_API bool
+    hash_table_sharded_validate(
+        const hash_table_sharded_t& sharded) {
+
+        bool is_valid = true;
+        is_valid &= (sharded.shards      != NULL);
+        is_valid &= (sharded.shard_count != 0);
+        is_valid &= (sharded.shard_mask  == (sharded.shard_count - 1));
+        return(is_valid);
+    }
+
+    SLD_API bool
+    hash_table_sharded_reset(
+        hash_table_sharded_t& sharded) {
 
+        const bool is_valid = hash_table_sharded_validate(sharded);
+        if (!is_valid) return(is_valid);
+
+        for (
+            u32 shard_index = 0;
+            shard_index < sharded.shard_count;
+            ++shard_index) {
+
+            hash_table_shard_t& shard    = sharded.shards[shard_index];
+            const u32           sequence = hash_table_shard_write_begin(shard);
+            (void)hash_table_reset(shard.table);
+            hash_table_shard_write_end(shard, sequence);
+        }
         return(is_valid);
     }
-};
\ No newline at end of file
+
+    SLD_API u32
+    hash_table_sharded_get_count(
+        const hash_table_sharded_t& sharded) {
+
+        // a snapshot, shards can change while they're being summed
+        u32 count = 0;
+        for (
+            u32 shard_index = 0;
+            shard_index < sharded.shard_count;
+            ++shard_index) {
+
+            const hash_table_shard_t& shard = sharded.shards[shard_index];
+            count += ((const volatile u32&)shard.table.count);
+        }
+        return(count);
+    }
+
+    SLD_API bool
+    hash_table_sharded_insert(
+        hash_table_sharded_t&   sharded,
+        const hash_table_key_t& key,
+        const byte*             value) {
+
+        bool is_valid = true;
+        is_valid &= (key.data   != NULL);
+        is_valid &= (key.length != 0);
+        is_valid &= (key.length <= 0xFFFFFFFF);
+        if (!is_valid) return(is_valid);
+
+        const hash128_t hash        = hash_table_hash_key(key);
+        const bool      is_inserted = hash_table_sharded_insert_hash(sharded, hash, value);
+        return(is_inserted);
+    }
+
+    SLD_API bool
+    hash_table_sharded_insert_hash(
+        hash_table_sharded_t& sharded,
+        const hash128_t&      hash,
+        const byte*           value) {
+
+        const bool is_valid = hash_table_sharded_validate(sharded);
+        if (!is_valid) return(is_valid);
+
+        hash_table_shard_t& shard       = hash_table_sharded_get_shard(sharded, hash);
+        const u32           sequence    = hash_table_shard_write_begin(shard);
+        const bool          is_inserted = hash_table_insert_hash(shard.table, hash, value);
+        hash_table_shard_write_end(shard, sequence);
+        return(is_inserted);
+    }
+
+    SLD_API bool
+    hash_table_sharded_remove(
+        hash_table_sharded_t&   sharded,
+        const hash_table_key_t& key) {
+
+        bool is_valid = true;
+        is_valid &= (key.data   != NULL);
+        is_valid &= (key.length != 0);
+        is_valid &= (key.length <= 0xFFFFFFFF);
+        if (!is_valid) return(is_valid);
+
+        const hash128_t hash       = hash_table_hash_key(key);
+        const bool      is_removed = hash_table_sharded_remove_hash(sharded, hash);
+        return(is_removed);
+    }
+
+    SLD_API bool
+    hash_table_sharded_remove_hash(
+        hash_table_sharded_t& sharded,
+        const hash128_t&      hash) {
+
+        const bool is_valid = hash_table_sharded_validate(sharded);
+        if (!is_valid) return(is_valid);
+
+        hash_table_shard_t& shard      = hash_table_sharded_get_shard(sharded, hash);
+        const u32           sequence   = hash_table_shard_write_begin(shard);
+        const bool          is_removed = hash_table_remove_hash(shard.table, hash);
+        hash_table_shard_write_end(shard, sequence);
+        return(is_removed);
+    }
+
+    SLD_API bool
+    hash_table_sharded_search(
+        const hash_table_sharded_t& sharded,
+        const hash_table_key_t&     key,
+        byte*                       value) {
+
+        bool is_valid = true;
+        is_valid &= (key.data   != NULL);
+        is_valid &= (key.length != 0);
+        is_valid &= (key.length <= 0xFFFFFFFF);
+        if (!is_valid) return(is_valid);
+
+        const hash128_t hash     = hash_table_hash_key(key);
+        const bool      is_found = hash_table_sharded_search_hash(sharded, hash, value);
+        return(is_found);
+    }
+
+    SLD_API bool
+    hash_table_sharded_search_hash(
+        const hash_table_sharded_t& sharded,
+        const hash128_t&            hash,
+        byte*                       value) {
+
+        // NOTE(SAM): the value is copied out, a pointer into the shard could be
+        // overwritten as soon as we return. value can be NULL to only test the key
+        const bool is_valid = hash_table_sharded_validate(sharded);
+        if (!is_valid) return(is_valid);
+
+        hash_table_shard_t& shard    = hash_table_sharded_get_shard(sharded, hash);
+        bool                is_found = false;
+        for (;;) {
+
+            const u32 sequence_begin = shard.sequence.load(std::memory_order_acquire);
+            if (sequence_begin & 1) {
+                _mm_pause();
+                continue;
+            }
+
+            // this can read a table that's mid write, nothing here can fault on
+            // a torn read and the sequence check throws the result away
+            hash_table_value_t table_value;
+            is_found = hash_table_search_hash(shard.table, hash, table_value);
+            if (is_found && value != NULL && sharded.stride != 0) {
+                memcpy(value, table_value.data, sharded.stride);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const u32 sequence_end = shard.sequence.load(std::memory_order_relaxed);
+            if (sequence_begin == sequence_end) break;
+        }
+        return(is_found);
+    }
+};
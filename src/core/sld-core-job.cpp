@@ -0,0 +1,843 @@
+#pragma once
+
+#include <new>
+#include <stdio.h>
+#include <immintrin.h>
+
+#include "sld-job.hpp"
+#include "sld-os-system.hpp"
+#include "sld-os-memory.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // GLOBALS
+    //-------------------------------------------------------------------
+
+    // the worker running on this thread, NULL if this thread isn't one
+    SLD_GLOBAL thread_local job_worker_t* _job_worker = NULL;
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    struct job_system_layout_t {
+        u32 worker_count;
+        u32 deque_capacity;
+        u32 fiber_count;
+        u64 fiber_stack_size;
+        u64 fiber_stride;
+        u64 offset_slots;
+        u64 offset_inject;
+        u64 offset_fibers;
+        u64 offset_fibers_free;
+        u64 offset_fibers_waiting;
+        u64 size_total;
+    };
+
+    struct job_parallel_for_t {
+        job_parallel_for_f function;
+        void*              data;
+        u64                count;
+        u64                grain;
+        std::atomic<u64>   cursor;
+    };
+
+    SLD_INTERNAL SLD_JOB_NOINLINE job_worker_t*
+    job_worker_get(
+        void) {
+
+        // NOTE(SAM): a fiber can park on one thread and wake up on another, and the
+        // compiler is allowed to keep a thread local's address across the switch.
+        // reading it through a call it can't see into makes every read a fresh one
+        return(_job_worker);
+    }
+
+    SLD_INTERNAL job_worker_t*
+    job_worker_get_for(
+        const job_system_t& system) {
+
+        job_worker_t* worker = job_worker_get();
+        return((worker && worker->system == &system) ? worker : NULL);
+    }
+
+    SLD_INTERNAL bool
+    job_system_layout(
+        const job_system_config_t& config,
+        job_system_layout_t&       layout) {
+
+        const u32 worker_count   = config.worker_count;
+        const u32 deque_capacity = config.deque_capacity;
+
+        layout.worker_count = worker_count;
+        if (layout.worker_count == 0) {
+            os_system_cpu_info cpu_info;
+            os_system_get_cpu_info(cpu_info);
+            layout.worker_count = cpu_info.core_count_logical;
+        }
+        if (layout.worker_count == 0)                   layout.worker_count = 1;
+        if (layout.worker_count > JOB_WORKER_COUNT_MAX) layout.worker_count = JOB_WORKER_COUNT_MAX;
+
+        const u64 capacity_pow2 = size_round_up_pow2(deque_capacity);
+        if (deque_capacity == 0 || capacity_pow2 > QUEUE_MPMC_CAPACITY_MAX) return(false);
+        layout.deque_capacity = (u32)capacity_pow2;
+
+        // a worker needs a spare fiber to switch to every time one parks
+        layout.fiber_count = config.fiber_count;
+        if (layout.fiber_count != 0 && layout.fiber_count < (layout.worker_count * 2)) {
+            layout.fiber_count = (layout.worker_count * 2);
+        }
+        if (layout.fiber_count > QUEUE_MPMC_CAPACITY_MAX) return(false);
+
+        // every stack has an uncommitted guard page under it. when the os makes
+        // the stacks itself each fiber only needs room for its start data
+        const u64 page_size = os_memory_align_to_page(1);
+        layout.fiber_stack_size = (layout.fiber_count != 0)
+            ? os_memory_align_to_page((config.fiber_stack_size != 0) ? config.fiber_stack_size : JOB_FIBER_STACK_SIZE_DEFAULT)
+            : 0;
+        layout.fiber_stride = OS_FIBER_IS_STACK_OWNED
+            ? OS_FIBER_START_SIZE
+            : (layout.fiber_stack_size + page_size);
+
+        // workers, then every worker's deque slots, then the inject queue,
+        // then the fibers and their free and waiting queues
+        const u64 size_workers        = (u64)layout.worker_count * sizeof(job_worker_t);
+        const u64 size_slots          = (u64)layout.worker_count * layout.deque_capacity * sizeof(job_deque_slot_t);
+        const u64 size_inject         = queue_mpmc_memory_size<job_entry_t>(layout.deque_capacity);
+        const u64 size_fibers         = (u64)layout.fiber_count * sizeof(job_fiber_t);
+        const u64 size_fibers_queue   = (layout.fiber_count != 0) ? queue_mpmc_memory_size<u32>(layout.fiber_count) : 0;
+        const u64 alignment_queue     = alignof(queue_mpmc_t<job_entry_t>);
+
+        layout.offset_slots          = size_workers;
+        layout.offset_inject         = size_align_pow_2(layout.offset_slots + size_slots, alignment_queue);
+        layout.offset_fibers         = size_align_pow_2(layout.offset_inject + size_inject, alignof(job_fiber_t));
+        layout.offset_fibers_free    = size_align_pow_2(layout.offset_fibers + size_fibers, alignment_queue);
+        layout.offset_fibers_waiting = layout.offset_fibers_free + size_fibers_queue;
+        layout.size_total            = layout.offset_fibers_waiting + size_fibers_queue;
+        return(true);
+    }
+
+    SLD_INTERNAL bool
+    job_deque_push(
+        job_deque_t&   deque,
+        const job_t&   job,
+        job_counter_t* counter) {
+
+        // owner only
+        const s64 bottom = deque.bottom.load(std::memory_order_relaxed);
+        const s64 top    = deque.top.load(std::memory_order_acquire);
+        if ((bottom - top) > (s64)deque.mask) return(false);
+
+        job_deque_slot_t& slot = deque.slots[bottom & deque.mask];
+        slot.function.store(job.function, std::memory_order_relaxed);
+        slot.data.store    (job.data,     std::memory_order_relaxed);
+        slot.counter.store (counter,      std::memory_order_relaxed);
+
+        deque.bottom.store(bottom + 1, std::memory_order_release);
+        return(true);
+    }
+
+    SLD_INTERNAL bool
+    job_deque_pop(
+        job_deque_t& deque,
+        job_entry_t& entry) {
+
+        // owner only, takes the newest job. bottom is moved first so a thief
+        // racing for the last job sees it gone, then whoever wins the cas on top gets it
+        const s64 bottom = deque.bottom.load(std::memory_order_relaxed) - 1;
+        deque.bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        s64 top = deque.top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            deque.bottom.store(bottom + 1, std::memory_order_relaxed);
+            return(false);
+        }
+
+        const job_deque_slot_t& slot = deque.slots[bottom & deque.mask];
+        entry.job.function = slot.function.load(std::memory_order_relaxed);
+        entry.job.data     = slot.data.load    (std::memory_order_relaxed);
+        entry.counter      = slot.counter.load (std::memory_order_relaxed);
+        if (top != bottom) return(true);
+
+        const bool is_taken = deque.top.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        deque.bottom.store(bottom + 1, std::memory_order_relaxed);
+        return(is_taken);
+    }
+
+    SLD_INTERNAL bool
+    job_deque_steal(
+        job_deque_t& deque,
+        job_entry_t& entry) {
+
+        // any thread, takes the oldest job
+        s64 top = deque.top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const s64 bottom = deque.bottom.load(std::memory_order_acquire);
+        if (top >= bottom) return(false);
+
+        const job_deque_slot_t& slot = deque.slots[top & deque.mask];
+        entry.job.function = slot.function.load(std::memory_order_relaxed);
+        entry.job.data     = slot.data.load    (std::memory_order_relaxed);
+        entry.counter      = slot.counter.load (std::memory_order_relaxed);
+
+        const bool is_taken = deque.top.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        return(is_taken);
+    }
+
+    SLD_INTERNAL bool
+    job_take(
+        job_system_t& system,
+        job_worker_t* worker,
+        job_entry_t&  entry) {
+
+        // own deque, then the inject queue, then steal starting at a random worker
+        bool is_taken = (worker != NULL) && job_deque_pop(worker->deque, entry);
+        is_taken = is_taken || system.inject->dequeue(entry);
+
+        if (!is_taken) {
+
+            u32 start = 0;
+            if (worker != NULL) {
+                worker->steal_seed ^= (worker->steal_seed << 13);
+                worker->steal_seed ^= (worker->steal_seed >> 17);
+                worker->steal_seed ^= (worker->steal_seed << 5);
+                start = worker->steal_seed;
+            }
+
+            for (
+                u32 attempt = 0;
+                attempt < system.worker_count && !is_taken;
+                ++attempt) {
+
+                job_worker_t& victim = system.workers[(start + attempt) % system.worker_count];
+                if (&victim == worker) continue;
+                is_taken = job_deque_steal(victim.deque, entry);
+            }
+        }
+
+        if (is_taken) system.pending.fetch_sub(1, std::memory_order_relaxed);
+        return(is_taken);
+    }
+
+    SLD_INTERNAL void
+    job_run(
+        job_entry_t& entry) {
+
+        entry.job.function(entry.job.data);
+        if (entry.counter) entry.counter->value.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    SLD_INTERNAL void
+    job_wake(
+        job_system_t& system,
+        const u32     count) {
+
+        // pending was raised before this, a worker going to sleep raises sleeping
+        // and then checks pending, so one of the two sides always sees the other.
+        // locking before the signal stops it landing between that check and the wait
+        if (system.sleeping.load(std::memory_order_seq_cst) == 0) return;
+
+        os_thread_mutex_lock(system.sleep_mutex);
+        if (count == 1) os_thread_condition_signal   (system.sleep_condition);
+        else            os_thread_condition_broadcast(system.sleep_condition);
+        os_thread_mutex_unlock(system.sleep_mutex);
+    }
+
+    SLD_INTERNAL void
+    job_worker_sleep(
+        job_system_t& system) {
+
+        os_thread_mutex_lock(system.sleep_mutex);
+        system.sleeping.fetch_add(1, std::memory_order_seq_cst);
+
+        // parked fibers can be woken by any job finishing, so workers don't
+        // sleep while there are any, they keep checking them instead
+        while (
+            system.pending.load(std::memory_order_seq_cst)              <= 0 &&
+            system.fibers.waiting_count.load(std::memory_order_seq_cst) == 0 &&
+            system.is_running.load(std::memory_order_acquire)            != 0) {
+
+            os_thread_condition_wait(system.sleep_condition, system.sleep_mutex);
+        }
+
+        system.sleeping.fetch_sub(1, std::memory_order_seq_cst);
+        os_thread_mutex_unlock(system.sleep_mutex);
+    }
+
+    SLD_INTERNAL void
+    job_worker_set_name(
+        os_thread& thread,
+        const u32  worker_index) {
+
+        cchar name[OS_THREAD_NAME_SIZE_MAX];
+        snprintf(name, sizeof(name), "sld-job-%u", worker_index);
+        (void)os_thread_set_name(thread, name);
+    }
+
+    // both queues have a slot for every fiber, but a vyukov enqueue still fails
+    // while a dequeue of the slot it wants is half done on another thread. dropping
+    // the index would lose the fiber for good, so wait the dequeue out
+    SLD_INTERNAL void
+    job_fiber_enqueue(
+        queue_mpmc_t<u32>* queue,
+        const u32          fiber_index) {
+
+        u32 spin_count = 0;
+        while (!queue->enqueue(fiber_index)) {
+            if (++spin_count < JOB_SPIN_COUNT) _mm_pause();
+            else                               os_thread_yield();
+        }
+    }
+
+    SLD_INTERNAL void
+    job_fiber_after_switch(
+        job_system_t& system) {
+
+        // runs first thing on whichever fiber a worker just switched to, the
+        // previous fiber is off this thread's stack now so it can be handed out
+        job_worker_t* worker   = job_worker_get();
+        job_fiber_t*  previous = worker->fiber_previous;
+        if (previous == NULL) return;
+
+        worker->fiber_previous = NULL;
+
+        switch (worker->fiber_previous_state) {
+
+            case (job_fiber_previous_e_free): {
+                job_fiber_enqueue(system.fibers.free, previous->index);
+            } break;
+
+            case (job_fiber_previous_e_wait): {
+                system.fibers.waiting_count.fetch_add(1, std::memory_order_seq_cst);
+                job_fiber_enqueue(system.fibers.waiting, previous->index);
+            } break;
+
+            default: break;
+        }
+    }
+
+    SLD_INTERNAL void
+    job_fiber_switch(
+        job_system_t& system,
+        job_worker_t* worker,
+        job_fiber_t*  fiber_next,
+        const u32     previous_state) {
+
+        job_fiber_t* fiber_current = worker->fiber_current;
+        worker->fiber_previous       = fiber_current;
+        worker->fiber_previous_state = previous_state;
+        worker->fiber_current        = fiber_next;
+
+        os_fiber_switch(fiber_current->fiber, fiber_next->fiber);
+
+        // switched back to, maybe on another worker
+        job_fiber_after_switch(system);
+    }
+
+    SLD_INTERNAL bool
+    job_fiber_resume_waiting(
+        job_system_t& system,
+        job_worker_t* worker) {
+
+        // looks at one parked fiber, if its counter is done this fiber goes back
+        // in the free queue and the worker carries on with the parked one
+        if (worker == NULL || worker->fiber_current == NULL) return(false);
+
+        u32 fiber_index = 0;
+        if (!system.fibers.waiting->dequeue(fiber_index)) return(false);
+
+        job_fiber_t* fiber = &system.fibers.array[fiber_index];
+        if (!job_counter_is_done(*fiber->wait_counter)) {
+            job_fiber_enqueue(system.fibers.waiting, fiber_index);
+            return(false);
+        }
+
+        system.fibers.waiting_count.fetch_sub(1, std::memory_order_seq_cst);
+        job_fiber_switch(system, worker, fiber, job_fiber_previous_e_free);
+        return(true);
+    }
+
+    SLD_INTERNAL void
+    job_worker_loop(
+        job_system_t& system) {
+
+        // the worker is looked up every time round, with fibers
+        // this loop can pick up on a different thread after any job
+        u32 spin_count = 0;
+        while (system.is_running.load(std::memory_order_acquire) != 0) {
+
+            job_worker_t* worker = job_worker_get();
+            job_entry_t   entry;
+            if (job_take(system, worker, entry)) {
+                job_run(entry);
+                spin_count = 0;
+                continue;
+            }
+
+            if (job_fiber_resume_waiting(system, worker)) {
+                spin_count = 0;
+                continue;
+            }
+
+            if (spin_count < JOB_SPIN_COUNT) {
+                _mm_pause();
+                ++spin_count;
+                continue;
+            }
+
+            job_worker_sleep(system);
+            spin_count = 0;
+        }
+    }
+
+    SLD_INTERNAL void
+    job_fiber_main(
+        void* data) {
+
+        job_system_t& system = *(job_system_t*)data;
+        job_fiber_after_switch(system);
+        job_worker_loop(system);
+
+        // shutting down, this fiber is done and the thread goes back to being one
+        job_worker_t* worker = job_worker_get();
+        job_fiber_t*  fiber  = worker->fiber_current;
+        worker->fiber_current  = NULL;
+        worker->fiber_previous = NULL;
+        os_fiber_switch(fiber->fiber, worker->fiber_thread);
+    }
+
+    SLD_INTERNAL void
+    job_worker_main(
+        os_thread_context& context) {
+
+        job_worker_t* worker = (job_worker_t*)context.data.ptr;
+        job_system_t& system = *worker->system;
+        _job_worker = worker;
+
+        // the worker names itself, its thread handle isn't written until create
+        // returns on the thread that made it. init pins it once that's happened
+        os_thread thread_self;
+        os_thread_get_current(thread_self);
+        job_worker_set_name(thread_self, worker->index);
+
+        // with fibers the thread just starts one and waits for shutdown to switch back
+        u32  fiber_index = 0;
+        bool is_fiber    = (system.fibers.count != 0);
+        is_fiber = is_fiber && os_fiber_from_thread(worker->fiber_thread);
+        is_fiber = is_fiber && system.fibers.free->dequeue(fiber_index);
+
+        if (is_fiber) {
+            worker->fiber_current  = &system.fibers.array[fiber_index];
+            worker->fiber_previous = NULL;
+            os_fiber_switch(worker->fiber_thread, worker->fiber_current->fiber);
+        }
+        else job_worker_loop(system);
+
+        if (system.fibers.count != 0) (void)os_fiber_to_thread(worker->fiber_thread);
+        _job_worker = NULL;
+    }
+
+    SLD_INTERNAL void
+    job_parallel_for_run(
+        void* data) {
+
+        // every job pulls ranges off the shared cursor until there are none left,
+        // so a slow range doesn't hold up the ranges queued behind it
+        job_parallel_for_t* parallel_for = (job_parallel_for_t*)data;
+
+        for (;;) {
+            const u64 begin = parallel_for->cursor.fetch_add(parallel_for->grain, std::memory_order_relaxed);
+            if (begin >= parallel_for->count) break;
+
+            const u64 end = ((parallel_for->count - begin) < parallel_for->grain)
+                ? parallel_for->count
+                : (begin + parallel_for->grain);
+            parallel_for->function(begin, end, parallel_for->data);
+        }
+    }
+
+    SLD_INTERNAL bool
+    job_system_init_fibers(
+        job_system_t&              system,
+        const memory_t&            memory,
+        const job_system_layout_t& layout) {
+
+        if (layout.fiber_count == 0) return(true);
+
+        system.fibers.array   = (job_fiber_t*)(memory.start + layout.offset_fibers);
+        system.fibers.free    = queue_mpmc_init_from_memory<u32>(
+            (void*)(memory.start + layout.offset_fibers_free),
+            layout.offset_fibers_waiting - layout.offset_fibers_free
+        );
+        system.fibers.waiting = queue_mpmc_init_from_memory<u32>(
+            (void*)(memory.start + layout.offset_fibers_waiting),
+            layout.size_total - layout.offset_fibers_waiting
+        );
+        if (!system.fibers.free || !system.fibers.waiting) return(false);
+
+        // one reservation for every stack, each stack is committed above a
+        // guard page that stays reserved so running off the end faults. when the
+        // os owns the stacks this is just the start data, committed in one go
+        system.fibers.stacks.size = (u64)layout.fiber_count * layout.fiber_stride;
+        system.fibers.stacks.ptr  = os_memory_reserve(NULL, system.fibers.stacks.size);
+        if (!system.fibers.stacks.ptr) return(false);
+
+        const u64 page_size = OS_FIBER_IS_STACK_OWNED ? 0 : (layout.fiber_stride - layout.fiber_stack_size);
+        bool      is_init   = true;
+        if (OS_FIBER_IS_STACK_OWNED) {
+            is_init &= (os_memory_commit(system.fibers.stacks.ptr, system.fibers.stacks.size) != NULL);
+        }
+
+        u32 fiber_count_init = 0;
+        for (
+            u32 fiber_index = 0;
+            fiber_index < layout.fiber_count && is_init;
+            ++fiber_index) {
+
+            job_fiber_t* fiber = new (&system.fibers.array[fiber_index]) job_fiber_t;
+            fiber->fiber.os_handle = NULL;
+            fiber->wait_counter    = NULL;
+            fiber->index           = fiber_index;
+            ++fiber_count_init;
+
+            void* stack = (void*)(system.fibers.stacks.start + (fiber_index * layout.fiber_stride) + page_size);
+            is_init &= OS_FIBER_IS_STACK_OWNED || (os_memory_commit(stack, layout.fiber_stack_size) != NULL);
+            is_init &= is_init && os_fiber_create(fiber->fiber, stack, layout.fiber_stack_size, job_fiber_main, &system);
+            is_init &= is_init && system.fibers.free->enqueue(fiber_index);
+        }
+
+        if (!is_init) {
+            for (
+                u32 fiber_index = 0;
+                fiber_index < fiber_count_init;
+                ++fiber_index) {
+
+                job_fiber_t& fiber = system.fibers.array[fiber_index];
+                if (fiber.fiber.os_handle != NULL) (void)os_fiber_destroy(fiber.fiber);
+            }
+            (void)os_memory_release(system.fibers.stacks.ptr, system.fibers.stacks.size);
+            system.fibers.stacks.ptr = NULL;
+        }
+        return(is_init);
+    }
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    SLD_API void
+    job_system_config_default(
+        job_system_config_t& config) {
+
+        config.worker_count     = 0;
+        config.deque_capacity   = JOB_DEQUE_CAPACITY_DEFAULT;
+        config.fiber_count      = 0;
+        config.fiber_stack_size = JOB_FIBER_STACK_SIZE_DEFAULT;
+        config.is_pinned        = false;
+    }
+
+    SLD_API u64
+    job_system_memory_size(
+        const job_system_config_t& config) {
+
+        // fiber stacks aren't part of this, they're reserved from the os on init
+        job_system_layout_t layout;
+        const bool is_valid = job_system_layout(config, layout);
+        return(is_valid ? layout.size_total : 0);
+    }
+
+    SLD_API bool
+    job_system_init(
+        job_system_t&              system,
+        const memory_t&            memory,
+        const job_system_config_t& config) {
+
+        job_system_layout_t layout;
+
+        bool can_init = true;
+        can_init &= job_system_layout(config, layout);
+        can_init &= (memory.start != 0);
+        can_init &= (memory.size  >= layout.size_total);
+        can_init &= ((memory.start & (alignof(job_worker_t) - 1)) == 0);
+        if (!can_init) return(can_init);
+
+        system.worker_count   = layout.worker_count;
+        system.deque_capacity = layout.deque_capacity;
+        system.is_pinned      = config.is_pinned;
+        system.workers        = (job_worker_t*)memory.start;
+        system.inject         = queue_mpmc_init_from_memory<job_entry_t>(
+            (void*)(memory.start + layout.offset_inject),
+            layout.size_total - layout.offset_inject
+        );
+        system.is_running.store(1, std::memory_order_relaxed);
+        system.pending.store   (0, std::memory_order_relaxed);
+        system.sleeping.store  (0, std::memory_order_relaxed);
+
+        system.fibers.count        = layout.fiber_count;
+        system.fibers.stack_size   = layout.fiber_stack_size;
+        system.fibers.stacks.start = 0;
+        system.fibers.stacks.size  = 0;
+        system.fibers.array        = NULL;
+        system.fibers.free         = NULL;
+        system.fibers.waiting      = NULL;
+        system.fibers.waiting_count.store(0, std::memory_order_relaxed);
+
+        bool is_init = (system.inject != NULL);
+        is_init &= os_thread_mutex_create    (system.sleep_mutex);
+        is_init &= os_thread_condition_create(system.sleep_condition);
+        is_init &= is_init && job_system_init_fibers(system, memory, layout);
+        if (!is_init) return(is_init);
+
+        job_deque_slot_t* slots = (job_deque_slot_t*)(memory.start + layout.offset_slots);
+        for (
+            u32 worker_index = 0;
+            worker_index < system.worker_count;
+            ++worker_index) {
+
+            job_worker_t* worker = new (&system.workers[worker_index]) job_worker_t;
+            worker->deque.slots          = new (&slots[worker_index * system.deque_capacity]) job_deque_slot_t[system.deque_capacity];
+            worker->deque.mask           = (system.deque_capacity - 1);
+            worker->deque.top.store   (0, std::memory_order_relaxed);
+            worker->deque.bottom.store(0, std::memory_order_relaxed);
+            worker->system               = &system;
+            worker->index                = worker_index;
+            worker->steal_seed           = (worker_index + 1) * 0x9E3779B9;
+            worker->thread.os_handle     = NULL;
+            worker->context.function     = job_worker_main;
+            worker->context.data.ptr     = worker;
+            worker->context.data.size    = sizeof(job_worker_t);
+            worker->fiber_thread.os_handle = NULL;
+            worker->fiber_current          = NULL;
+            worker->fiber_previous         = NULL;
+            worker->fiber_previous_state   = job_fiber_previous_e_none;
+        }
+
+        // the calling thread is worker 0, it runs jobs whenever it waits
+        _job_worker = &system.workers[0];
+
+        for (
+            u32 worker_index = 1;
+            worker_index < system.worker_count;
+            ++worker_index) {
+
+            job_worker_t& worker = system.workers[worker_index];
+            is_init &= os_thread_create(worker.thread, worker.context);
+        }
+
+        // worker N goes on the Nth core we're allowed on. linux reads that from the
+        // calling thread's mask, so this thread is pinned last
+        for (
+            u32 worker_index = 1;
+            worker_index < system.worker_count && system.is_pinned;
+            ++worker_index) {
+
+            job_worker_t& worker = system.workers[worker_index];
+            is_init &= is_init && os_thread_set_affinity(worker.thread, worker_index);
+        }
+        if (system.is_pinned && is_init) {
+            os_thread thread_self;
+            os_thread_get_current(thread_self);
+            is_init &= os_thread_set_affinity(thread_self, 0);
+        }
+
+        if (!is_init) job_system_shutdown(system);
+        return(is_init);
+    }
+
+    SLD_API bool
+    job_system_validate(
+        const job_system_t& system) {
+
+        bool is_valid = true;
+        is_valid &= (system.workers      != NULL);
+        is_valid &= (system.inject       != NULL);
+        is_valid &= (system.worker_count != 0);
+        is_valid &= (system.worker_count <= JOB_WORKER_COUNT_MAX);
+        is_valid &= size_is_pow_2(system.deque_capacity);
+        return(is_valid);
+    }
+
+    SLD_API void
+    job_system_shutdown(
+        job_system_t& system) {
+
+        // workers finish the job they're on and exit, anything still queued is dropped
+        assert(job_system_validate(system));
+
+        os_thread_mutex_lock(system.sleep_mutex);
+        system.is_running.store(0, std::memory_order_release);
+        os_thread_condition_broadcast(system.sleep_condition);
+        os_thread_mutex_unlock(system.sleep_mutex);
+
+        for (
+            u32 worker_index = 1;
+            worker_index < system.worker_count;
+            ++worker_index) {
+
+            job_worker_t& worker = system.workers[worker_index];
+            if (worker.thread.os_handle != NULL) os_thread_join(worker.thread);
+        }
+
+        if (job_worker_get_for(system)) _job_worker = NULL;
+
+        // fibers still parked are dropped with their jobs
+        for (
+            u32 fiber_index = 0;
+            fiber_index < system.fibers.count && system.fibers.array;
+            ++fiber_index) {
+
+            job_fiber_t& fiber = system.fibers.array[fiber_index];
+            if (fiber.fiber.os_handle != NULL) (void)os_fiber_destroy(fiber.fiber);
+        }
+        if (system.fibers.stacks.ptr != NULL) {
+            (void)os_memory_release(system.fibers.stacks.ptr, system.fibers.stacks.size);
+            system.fibers.stacks.ptr = NULL;
+        }
+
+        os_thread_condition_destroy(system.sleep_condition);
+        os_thread_mutex_destroy    (system.sleep_mutex);
+    }
+
+    SLD_API u32
+    job_system_get_worker_count(
+        const job_system_t& system) {
+
+        return(system.worker_count);
+    }
+
+    SLD_API u32
+    job_system_get_worker_index(
+        const job_system_t& system) {
+
+        const job_worker_t* worker       = job_worker_get_for(system);
+        const u32           worker_index = worker ? worker->index : JOB_WORKER_INDEX_INVALID;
+        return(worker_index);
+    }
+
+    SLD_API void
+    job_submit(
+        job_system_t&  system,
+        const job_t*   jobs,
+        const u32      count,
+        job_counter_t* counter) {
+
+        assert(job_system_validate(system));
+        assert(jobs != NULL || count == 0);
+        if (count == 0) return;
+
+        if (counter) counter->value.fetch_add(count, std::memory_order_relaxed);
+
+        // workers push to their own deque, anyone else goes through the inject queue.
+        // if that's full the job just runs here
+        job_worker_t* worker       = job_worker_get_for(system);
+        u32           count_queued = 0;
+
+        for (
+            u32 job_index = 0;
+            job_index < count;
+            ++job_index) {
+
+            const job_t& job = jobs[job_index];
+            assert(job.function != NULL);
+
+            job_entry_t entry;
+            entry.job     = job;
+            entry.counter = counter;
+
+            const bool is_queued = (worker != NULL)
+                ? job_deque_push(worker->deque, job, counter)
+                : system.inject->enqueue(entry);
+
+            if (is_queued) {
+                system.pending.fetch_add(1, std::memory_order_seq_cst);
+                ++count_queued;
+            }
+            else job_run(entry);
+        }
+
+        if (count_queued != 0) job_wake(system, count_queued);
+    }
+
+    SLD_API void
+    job_wait(
+        job_system_t&  system,
+        job_counter_t& counter) {
+
+        // on a fiber this parks the fiber until the counter is done and the worker
+        // moves on to a free one. anywhere else, or with no free fiber, it runs
+        // other jobs until the counter is done
+        while (!job_counter_is_done(counter)) {
+
+            job_worker_t* worker      = job_worker_get_for(system);
+            u32           fiber_index = 0;
+
+            const bool can_park = (
+                worker                != NULL &&
+                worker->fiber_current != NULL &&
+                system.fibers.free->dequeue(fiber_index)
+            );
+
+            if (can_park) {
+                worker->fiber_current->wait_counter = &counter;
+                job_fiber_switch(system, worker, &system.fibers.array[fiber_index], job_fiber_previous_e_wait);
+                continue;
+            }
+
+            job_entry_t entry;
+            if (job_take(system, worker, entry)) job_run(entry);
+            else                                  _mm_pause();
+        }
+    }
+
+    SLD_API bool
+    job_counter_is_done(
+        const job_counter_t& counter) {
+
+        const bool is_done = (counter.value.load(std::memory_order_acquire) == 0);
+        return(is_done);
+    }
+
+    SLD_API void
+    job_parallel_for(
+        job_system_t&      system,
+        const u64          count,
+        const u64          grain,
+        job_parallel_for_f function,
+        void*              data) {
+
+        assert(job_system_validate(system));
+        assert(function != NULL);
+        if (count == 0) return;
+
+        job_parallel_for_t parallel_for;
+        parallel_for.function = function;
+        parallel_for.data     = data;
+        parallel_for.count    = count;
+        parallel_for.grain    = (grain != 0) ? grain : 1;
+        parallel_for.cursor.store(0, std::memory_order_relaxed);
+
+        // no more jobs than workers, the caller is one of them
+        const u64 range_count = (count + parallel_for.grain - 1) / parallel_for.grain;
+        const u32 job_count   = (range_count < system.worker_count) ? (u32)range_count : system.worker_count;
+
+        job_t jobs[JOB_WORKER_COUNT_MAX];
+        for (
+            u32 job_index = 0;
+            job_index < (job_count - 1);
+            ++job_index) {
+
+            jobs[job_index].function = job_parallel_for_run;
+            jobs[job_index].data     = &parallel_for;
+        }
+
+        job_counter_t counter;
+        counter.value.store(0, std::memory_order_relaxed);
+        job_submit(system, jobs, job_count - 1, &counter);
+
+        job_parallel_for_run(&parallel_for);
+        job_wait(system, counter);
+    }
+};
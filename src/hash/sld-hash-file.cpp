@@ -0,0 +1,77 @@
+#pragma once
+
+#include "sld-hash.hpp"
+#include "sld-os-file.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // FILE
+    //-------------------------------------------------------------------
+
+    SLD_API bool
+    hash128_file(
+        const hash128_seed_t& seed,
+        const os_file_handle  file_hnd,
+        hash128_t&            hash) {
+
+        bool can_hash = true;
+        can_hash &= (file_hnd != OS_FILE_HANDLE_INVALID);
+        if (!can_hash) return(can_hash);
+
+        const u64 file_size = os_file_get_size(file_hnd);
+        if (file_size == OS_FILE_SIZE_INVALID) return(false);
+
+        hash128_state_t state;
+        hash128_block_begin(state, seed);
+
+        // nothing to map in an empty file
+        if (file_size == 0) {
+            hash = hash128_block_end(state);
+            return(true);
+        }
+
+        const os_file_map_handle map_hnd = os_file_map_create(file_hnd);
+        if (map_hnd == NULL) return(false);
+
+        // views start on a multiple of the window, so it has to be a multiple of the granularity
+        const u64 granularity = os_file_map_get_granularity();
+        const u64 window_size = size_align_pow_2(HASH128_FILE_WINDOW_SIZE, granularity);
+
+        os_file_mapped_buffer view_current = {};
+        os_file_mapped_buffer view_next    = {};
+
+        const u64 view_size_first = (file_size < window_size) ? file_size : window_size;
+        bool      is_hashed       = os_file_map_view(map_hnd, 0, view_size_first, &view_current);
+        if (is_hashed) (void)os_file_map_prefetch(&view_current);
+
+        for (
+            u64 offset = 0;
+            is_hashed && offset < file_size;
+            offset += window_size) {
+
+            // start the next window reading in before we hash this one
+            const u64 offset_next = offset + window_size;
+            if (offset_next < file_size) {
+
+                const u64 size_left = file_size - offset_next;
+                const u64 view_size = (size_left < window_size) ? size_left : window_size;
+                is_hashed &= os_file_map_view(map_hnd, offset_next, view_size, &view_next);
+                if (is_hashed) (void)os_file_map_prefetch(&view_next);
+            }
+
+            if (is_hashed) hash128_block_consume(state, view_current.size, view_current.data);
+
+            is_hashed &= os_file_map_unview(&view_current);
+            view_current = view_next;
+            view_next    = {};
+        }
+
+        // only left over when something failed partway
+        if (view_current.data != NULL) (void)os_file_map_unview(&view_current);
+        (void)os_file_map_destroy(map_hnd);
+
+        if (is_hashed) hash = hash128_block_end(state);
+        return(is_hashed);
+    }
+};
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <zlib-ng.h>
+
+#include "sld-hash.hpp"
+#include "sld-job.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    struct hash128_parallel_t {
+        const hash128_seed_t* seed;
+        const byte*           data;
+        u32                   stride;
+        hash128_t*            hashes;
+    };
+
+    struct hash32_parallel_t {
+        hash32_seed_t seed;
+        const byte*   data;
+        u32           stride;
+        hash32_t*     hashes;
+    };
+
+    struct hash32_chunked_t {
+        const byte* data;
+        u32         length;
+        u32         chunk_size;
+        u32         chunk_crc[HASH32_PARALLEL_CHUNK_MAX];
+    };
+
+    SLD_INTERNAL bool
+    hash_parallel_is_worth_it(
+        const job_system_t& jobs,
+        const u32           count,
+        const u32           stride) {
+
+        const u64 size = (u64)count * (u64)stride;
+
+        bool is_worth_it = true;
+        is_worth_it &= (job_system_get_worker_count(jobs) > 1);
+        is_worth_it &= (size >= HASH_PARALLEL_SIZE_MIN);
+        return(is_worth_it);
+    }
+
+    // enough elements to make a range about HASH_PARALLEL_SIZE_RANGE of input,
+    // rounded up to whole cache lines of output
+    SLD_INTERNAL u64
+    hash_parallel_grain(
+        const u32 stride,
+        const u32 hash_size) {
+
+        const u64 hashes_per_line = HASH_PARALLEL_LINE_SIZE / hash_size;
+        const u64 grain_data      = (HASH_PARALLEL_SIZE_RANGE + stride - 1) / stride;
+        const u64 grain           = size_align_pow_2(grain_data, hashes_per_line);
+        return(grain);
+    }
+
+    SLD_INTERNAL void
+    hash128_parallel_range(
+        const u64 begin,
+        const u64 end,
+        void*     data) {
+
+        hash128_parallel_t* parallel = (hash128_parallel_t*)data;
+        const u64           offset   = begin * parallel->stride;
+
+        hash128_data_batch(
+            *parallel->seed,
+            (u32)(end - begin),
+            &parallel->data[offset],
+            parallel->stride,
+            &parallel->hashes[begin]
+        );
+    }
+
+    SLD_INTERNAL void
+    hash32_parallel_range(
+        const u64 begin,
+        const u64 end,
+        void*     data) {
+
+        hash32_parallel_t* parallel = (hash32_parallel_t*)data;
+        const u64          offset   = begin * parallel->stride;
+
+        hash32_batch(
+            parallel->seed,
+            &parallel->data[offset],
+            parallel->stride,
+            (u32)(end - begin),
+            &parallel->hashes[begin]
+        );
+    }
+
+    SLD_INTERNAL void
+    hash32_chunked_range(
+        const u64 begin,
+        const u64 end,
+        void*     data) {
+
+        hash32_chunked_t* chunked = (hash32_chunked_t*)data;
+
+        for (
+            u64 chunk = begin;
+            chunk < end;
+            ++chunk) {
+
+            // every chunk starts from zero, the seed only goes into the first fold
+            const u64 offset = chunk * chunked->chunk_size;
+            const u64 left   = chunked->length - offset;
+            const u32 length = (u32)((left < chunked->chunk_size) ? left : chunked->chunk_size);
+            chunked->chunk_crc[chunk] = zng_crc32(0, &chunked->data[offset], length);
+        }
+    }
+
+    //-------------------------------------------------------------------
+    // PARALLEL
+    //-------------------------------------------------------------------
+
+    SLD_API bool
+    hash128_data_batch_parallel(
+        job_system_t&         jobs,
+        const hash128_seed_t& seed,
+        const u32             count,
+        const byte*           data,
+        const u32             stride,
+        hash128_t*            hashes) {
+
+        bool can_hash = true;
+        can_hash &= (count  != 0);
+        can_hash &= (data   != NULL);
+        can_hash &= (stride != 0);
+        can_hash &= (hashes != NULL);
+        if (!can_hash) return(can_hash);
+
+        if (!hash_parallel_is_worth_it(jobs, count, stride)) {
+            return(hash128_data_batch(seed, count, data, stride, hashes));
+        }
+
+        hash128_parallel_t parallel;
+        parallel.seed   = &seed;
+        parallel.data   = data;
+        parallel.stride = stride;
+        parallel.hashes = hashes;
+
+        const u64 grain = hash_parallel_grain(stride, sizeof(hash128_t));
+        job_parallel_for(jobs, count, grain, hash128_parallel_range, &parallel);
+        return(true);
+    }
+
+    SLD_API bool
+    hash32_batch_parallel(
+        job_system_t&       jobs,
+        const hash32_seed_t seed,
+        const byte*         data,
+        const u32           stride,
+        const u32           count,
+        hash32_t*           hashes) {
+
+        bool can_hash = true;
+        can_hash &= (data   != NULL);
+        can_hash &= (stride != 0);
+        can_hash &= (count  != 0);
+        can_hash &= (hashes != NULL);
+        if (!can_hash) return(can_hash);
+
+        if (!hash_parallel_is_worth_it(jobs, count, stride)) {
+            return(hash32_batch(seed, data, stride, count, hashes));
+        }
+
+        hash32_parallel_t parallel;
+        parallel.seed   = seed;
+        parallel.data   = data;
+        parallel.stride = stride;
+        parallel.hashes = hashes;
+
+        const u64 grain = hash_parallel_grain(stride, sizeof(hash32_t));
+        job_parallel_for(jobs, count, grain, hash32_parallel_range, &parallel);
+        return(true);
+    }
+
+    SLD_API const hash32_t
+    hash32_parallel(
+        job_system_t&       jobs,
+        const hash32_seed_t seed,
+        const byte*         data,
+        const u32           length) {
+
+        bool can_split = true;
+        can_split &= (data   != NULL);
+        can_split &= (length >= HASH32_PARALLEL_SIZE_MIN);
+        can_split &= (job_system_get_worker_count(jobs) > 1);
+        if (!can_split) return(hash32(seed, data, length));
+
+        // chunks of at least HASH32_PARALLEL_CHUNK_SIZE, bigger when the buffer
+        // would need more than HASH32_PARALLEL_CHUNK_MAX of them. cache line multiples
+        // so no two chunks read the same line
+        const u64 chunk_count_min = (length + HASH32_PARALLEL_CHUNK_SIZE - 1) / HASH32_PARALLEL_CHUNK_SIZE;
+        const u64 chunk_count     = (chunk_count_min < HASH32_PARALLEL_CHUNK_MAX) ? chunk_count_min : HASH32_PARALLEL_CHUNK_MAX;
+        const u64 chunk_size      = size_align_pow_2((length + chunk_count - 1) / chunk_count, HASH_PARALLEL_LINE_SIZE);
+
+        hash32_chunked_t chunked;
+        chunked.data       = data;
+        chunked.length     = length;
+        chunked.chunk_size = (u32)chunk_size;
+
+        const u64 chunk_count_used = (length + chunk_size - 1) / chunk_size;
+        job_parallel_for(jobs, chunk_count_used, 1, hash32_chunked_range, &chunked);
+
+        // fold in order, the first chunk carries the seed
+        const u32 first_length = (u32)((length < chunk_size) ? length : chunk_size);
+        u32       crc          = zng_crc32_combine(seed.val, chunked.chunk_crc[0], first_length);
+        for (
+            u64 chunk = 1;
+            chunk < chunk_count_used;
+            ++chunk) {
+
+            const u64 left = length - (chunk * chunk_size);
+            const u64 size = (left < chunk_size) ? left : chunk_size;
+            crc = zng_crc32_combine(crc, chunked.chunk_crc[chunk], (z_off64_t)size);
+        }
+
+        const hash32_t hash = { crc };
+        return(hash);
+    }
+};
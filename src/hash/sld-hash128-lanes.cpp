@@ -0,0 +1,222 @@
+// NOTE(SAM): no #pragma once, sld-hash128.cpp includes this once per lane width
+// inside its own namespace. whoever includes it defines hash128_lanes_t,
+// HASH128_BATCH_LANE_COUNT, the lane primitives and SLD_HASH128_LANES_TARGET,
+// which every function here is compiled with
+
+    SLD_HASH128_LANES_TARGET SLD_INLINE hash128_lanes_t
+    hash128_lanes_load(
+        const byte* const* elements,
+        const u32          offset) {
+
+        __m128i regs[HASH128_BATCH_LANE_COUNT];
+        for (u32 index = 0; index < HASH128_BATCH_LANE_COUNT; ++index) {
+            regs[index] = _mm_loadu_si128((const __m128i*)&elements[index][offset]);
+        }
+        return(hash128_lanes_set(regs));
+    }
+
+    // MEOW_MIX_REG and MEOW_SHUFFLE, one step for every lane
+    SLD_HASH128_LANES_TARGET SLD_INLINE void
+    hash128_lanes_mix(
+        hash128_lanes_t&       r1,
+        hash128_lanes_t&       r2,
+        hash128_lanes_t&       r3,
+        hash128_lanes_t&       r4,
+        hash128_lanes_t&       r5,
+        const hash128_lanes_t& i1,
+        const hash128_lanes_t& i2,
+        const hash128_lanes_t& i3,
+        const hash128_lanes_t& i4) {
+
+        hash128_lanes_aesdec (r1, r2);
+        hash128_lanes_add    (r3, i1);
+        hash128_lanes_xor    (r2, i2);
+        hash128_lanes_aesdec (r2, r4);
+        hash128_lanes_add    (r5, i3);
+        hash128_lanes_xor    (r4, i4);
+    }
+
+    SLD_HASH128_LANES_TARGET SLD_INLINE void
+    hash128_lanes_mix_data(
+        hash128_lanes_t&   r1,
+        hash128_lanes_t&   r2,
+        hash128_lanes_t&   r3,
+        hash128_lanes_t&   r4,
+        hash128_lanes_t&   r5,
+        const byte* const* elements,
+        const u32          offset) {
+
+        // MEOW_MIX reads at +15, +0, +1 and +16, the odd two are the even two shifted
+        // by a byte either way, alignr shifts within each 128 bit lane so one key never
+        // sees another's bytes
+        const hash128_lanes_t low  = hash128_lanes_load(elements, offset + 0);
+        const hash128_lanes_t high = hash128_lanes_load(elements, offset + 16);
+        const hash128_lanes_t i1   = hash128_lanes_bytes_15 (high, low);
+        const hash128_lanes_t i3   = hash128_lanes_bytes_1  (high, low);
+        hash128_lanes_mix(r1, r2, r3, r4, r5, i1, low, i3, high);
+    }
+
+    SLD_HASH128_LANES_TARGET SLD_INLINE void
+    hash128_lanes_shuffle(
+        hash128_lanes_t&       r1,
+        hash128_lanes_t&       r2,
+        const hash128_lanes_t& r3,
+        hash128_lanes_t&       r4,
+        hash128_lanes_t&       r5,
+        const hash128_lanes_t& r6) {
+
+        hash128_lanes_aesdec (r1, r4);
+        hash128_lanes_add    (r2, r5);
+        hash128_lanes_xor    (r4, r6);
+        hash128_lanes_aesdec (r4, r2);
+        hash128_lanes_add    (r5, r6);
+        hash128_lanes_xor    (r2, r3);
+    }
+
+    // the under 32 byte tail MeowHash mixes in before the 32 byte lanes, this
+    // depends on the key address so every lane loads its own. it's only 128 bit
+    // but built with the lanes so it's vex encoded like them, legacy sse between
+    // the wide instructions pays for every switch
+    SLD_HASH128_LANES_TARGET SLD_INTERNAL void
+    hash128_meow_residual(
+        const byte* data,
+        const u32   length,
+        __m128i*    residual) {
+
+        __m128i reg_low  = _mm_setzero_si128();
+        __m128i reg_high = _mm_setzero_si128();
+
+        const byte* last       = data + (length & ~0xF);
+        const u32   length_odd = (length & 0xF);
+        if (length_odd) {
+
+            // never read past the page the key ends on
+            const __m128i reg_mask  = _mm_loadu_si128((const __m128i*)&MeowMaskLen[0x10 - length_odd]);
+            const addr    last_ok   = (((addr)(data + length - 1)) | (MEOW_PAGESIZE - 1)) - 16;
+            const u32     align     = ((addr)last > last_ok) ? (u32)((addr)last & 0xF) : 0;
+            const __m128i reg_shift = _mm_loadu_si128((const __m128i*)&MeowShiftAdjust[align]);
+
+            reg_low = _mm_loadu_si128((const __m128i*)(last - align));
+            reg_low = _mm_shuffle_epi8(reg_low, reg_shift);
+            reg_low = _mm_and_si128(reg_low, reg_mask);
+        }
+
+        if (length & 0x10) {
+            reg_high = reg_low;
+            reg_low  = _mm_loadu_si128((const __m128i*)(last - 0x10));
+        }
+
+        residual[0] = _mm_alignr_epi8(reg_low, reg_high, 15);
+        residual[1] = reg_low;
+        residual[2] = _mm_alignr_epi8(reg_low, reg_high, 1);
+        residual[3] = reg_high;
+    }
+
+    // HASH128_BATCH_LANE_COUNT keys of the same length under HASH128_BATCH_STRIDE_SMALL
+    SLD_HASH128_LANES_TARGET SLD_INTERNAL void
+    hash128_lanes_hash(
+        const hash128_seed_t& seed,
+        const byte* const*    elements,
+        const u32             length,
+        hash128_t*            hashes) {
+
+        hash128_lanes_t x0 = hash128_lanes_broadcast(_mm_loadu_si128((const __m128i*)&seed.buffer[0x00]));
+        hash128_lanes_t x1 = hash128_lanes_broadcast(_mm_loadu_si128((const __m128i*)&seed.buffer[0x10]));
+        hash128_lanes_t x2 = hash128_lanes_broadcast(_mm_loadu_si128((const __m128i*)&seed.buffer[0x20]));
+        hash128_lanes_t x3 = hash128_lanes_broadcast(_mm_loadu_si128((const __m128i*)&seed.buffer[0x30]));
+        hash128_lanes_t x4 = hash128_lanes_broadcast(_mm_loadu_si128((const __m128i*)&seed.buffer[0x40]));
+        hash128_lanes_t x5 = hash128_lanes_broadcast(_mm_loadu_si128((const __m128i*)&seed.buffer[0x50]));
+        hash128_lanes_t x6 = hash128_lanes_broadcast(_mm_loadu_si128((const __m128i*)&seed.buffer[0x60]));
+        hash128_lanes_t x7 = hash128_lanes_broadcast(_mm_loadu_si128((const __m128i*)&seed.buffer[0x70]));
+
+        // residual and length ingests
+        __m128i residual[4][HASH128_BATCH_LANE_COUNT];
+        for (u32 index = 0; index < HASH128_BATCH_LANE_COUNT; ++index) {
+
+            __m128i residual_lane[4];
+            hash128_meow_residual(elements[index], length, residual_lane);
+            residual[0][index] = residual_lane[0];
+            residual[1][index] = residual_lane[1];
+            residual[2][index] = residual_lane[2];
+            residual[3][index] = residual_lane[3];
+        }
+
+        const __m128i reg_zero   = _mm_setzero_si128();
+        const __m128i reg_length = _mm_set_epi64x(0, (s64)length);
+
+        hash128_lanes_mix(
+            x0, x4, x6, x1, x2,
+            hash128_lanes_set(residual[0]),
+            hash128_lanes_set(residual[1]),
+            hash128_lanes_set(residual[2]),
+            hash128_lanes_set(residual[3])
+        );
+        hash128_lanes_mix(
+            x1, x5, x7, x2, x3,
+            hash128_lanes_broadcast(_mm_alignr_epi8(reg_zero, reg_length, 15)),
+            hash128_lanes_broadcast(reg_zero),
+            hash128_lanes_broadcast(_mm_alignr_epi8(reg_zero, reg_length, 1)),
+            hash128_lanes_broadcast(reg_length)
+        );
+
+        // full 32 byte lanes
+        const u32 lane_count = (length >> 5) & 0x7;
+        if (lane_count > 0) hash128_lanes_mix_data(x2, x6, x0, x3, x4, elements, 0x00);
+        if (lane_count > 1) hash128_lanes_mix_data(x3, x7, x1, x4, x5, elements, 0x20);
+        if (lane_count > 2) hash128_lanes_mix_data(x4, x0, x2, x5, x6, elements, 0x40);
+        if (lane_count > 3) hash128_lanes_mix_data(x5, x1, x3, x6, x7, elements, 0x60);
+        if (lane_count > 4) hash128_lanes_mix_data(x6, x2, x4, x7, x0, elements, 0x80);
+        if (lane_count > 5) hash128_lanes_mix_data(x7, x3, x5, x0, x1, elements, 0xa0);
+        if (lane_count > 6) hash128_lanes_mix_data(x0, x4, x6, x1, x2, elements, 0xc0);
+
+        // mix down
+        hash128_lanes_shuffle(x0, x1, x2, x4, x5, x6);
+        hash128_lanes_shuffle(x1, x2, x3, x5, x6, x7);
+        hash128_lanes_shuffle(x2, x3, x4, x6, x7, x0);
+        hash128_lanes_shuffle(x3, x4, x5, x7, x0, x1);
+        hash128_lanes_shuffle(x4, x5, x6, x0, x1, x2);
+        hash128_lanes_shuffle(x5, x6, x7, x1, x2, x3);
+        hash128_lanes_shuffle(x6, x7, x0, x2, x3, x4);
+        hash128_lanes_shuffle(x7, x0, x1, x3, x4, x5);
+        hash128_lanes_shuffle(x0, x1, x2, x4, x5, x6);
+        hash128_lanes_shuffle(x1, x2, x3, x5, x6, x7);
+        hash128_lanes_shuffle(x2, x3, x4, x6, x7, x0);
+        hash128_lanes_shuffle(x3, x4, x5, x7, x0, x1);
+
+        hash128_lanes_add (x0, x2);
+        hash128_lanes_add (x1, x3);
+        hash128_lanes_add (x4, x6);
+        hash128_lanes_add (x5, x7);
+        hash128_lanes_xor (x0, x1);
+        hash128_lanes_xor (x4, x5);
+        hash128_lanes_add (x0, x4);
+
+        hash128_lanes_store(x0, hashes);
+    }
+
+    // every whole group of lanes in the batch, returns how many keys that was
+    SLD_HASH128_LANES_TARGET SLD_INTERNAL u32
+    hash128_data_batch_lanes(
+        const hash128_seed_t& seed,
+        const u32             count,
+        const byte*           data,
+        const u32             stride,
+        hash128_t*            hashes) {
+
+        const byte* element = data;
+        u32         index   = 0;
+        for (
+            ;
+            (index + HASH128_BATCH_LANE_COUNT) <= count;
+            index += HASH128_BATCH_LANE_COUNT) {
+
+            const byte* elements[HASH128_BATCH_LANE_COUNT];
+            for (u32 lane = 0; lane < HASH128_BATCH_LANE_COUNT; ++lane) {
+                elements[lane] = element;
+                element       += stride;
+            }
+            hash128_lanes_hash(seed, elements, stride, &hashes[index]);
+        }
+
+        return(index);
+    }
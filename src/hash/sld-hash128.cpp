@@ -1,11 +1,209 @@
 #pragma once
 
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#else
+#   include <cpuid.h>
+#endif
+
 #include <meow-hash/meow_hash_x64_aesni.h>
 #include "sld-hash.hpp"
 #include "sld-simd.hpp"
 
 namespace sld {
 
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    // NOTE(SAM): a small MeowHash is one long chain of aesdec, with plain AES-NI the
+    // out of order window already overlaps the next key in the loop so interleaving
+    // by hand buys nothing. VAES does two or four rounds in one instruction though.
+    // every key in a batch has the same length and so the same branches, so on a cpu
+    // with VAES we run the exact MeowHash steps on several keys at once, one key per
+    // 128 bit lane. results are bit for bit MeowHash. keys of 256 bytes and up have
+    // full blocks and go through MeowHash
+    //
+    // the lanes are built for avx512 and avx2 whatever the build flags, and the
+    // first batch picks the widest one the cpu and os both support. msvc has the
+    // intrinsics without /arch, gcc and clang get a target attribute per function
+    constexpr u32 HASH128_BATCH_STRIDE_SMALL = 256;
+
+    // hashes whole lane groups from the front of the batch, returns how many keys
+    typedef u32 (*hash128_batch_lanes_f)(const hash128_seed_t& seed, const u32 count, const byte* data, const u32 stride, hash128_t* hashes);
+
+#if defined(_MSC_VER)
+#   define SLD_HASH128_TARGET_VAES_512
+#   define SLD_HASH128_TARGET_VAES_256
+#else
+#   define SLD_HASH128_TARGET_VAES_512 __attribute__((target("aes,vaes,avx2,avx512f,avx512bw")))
+#   define SLD_HASH128_TARGET_VAES_256 __attribute__((target("aes,vaes,avx2")))
+#endif
+
+    namespace hash128_lanes_512 {
+
+#   define SLD_HASH128_LANES_TARGET SLD_HASH128_TARGET_VAES_512
+
+    constexpr u32 HASH128_BATCH_LANE_COUNT = 4;
+
+    typedef __m512i hash128_lanes_t;
+
+    SLD_HASH128_LANES_TARGET SLD_INLINE void hash128_lanes_aesdec (hash128_lanes_t& a, const hash128_lanes_t& b) { a = _mm512_aesdec_epi128 (a, b); }
+    SLD_HASH128_LANES_TARGET SLD_INLINE void hash128_lanes_add    (hash128_lanes_t& a, const hash128_lanes_t& b) { a = _mm512_add_epi64    (a, b); }
+    SLD_HASH128_LANES_TARGET SLD_INLINE void hash128_lanes_xor    (hash128_lanes_t& a, const hash128_lanes_t& b) { a = _mm512_xor_si512    (a, b); }
+
+    SLD_HASH128_LANES_TARGET SLD_INLINE hash128_lanes_t hash128_lanes_bytes_1  (const hash128_lanes_t& high, const hash128_lanes_t& low) { return(_mm512_alignr_epi8(high, low, 1));  }
+    SLD_HASH128_LANES_TARGET SLD_INLINE hash128_lanes_t hash128_lanes_bytes_15 (const hash128_lanes_t& high, const hash128_lanes_t& low) { return(_mm512_alignr_epi8(high, low, 15)); }
+
+    SLD_HASH128_LANES_TARGET SLD_INLINE hash128_lanes_t
+    hash128_lanes_set(
+        const __m128i* regs) {
+
+        hash128_lanes_t lanes = _mm512_castsi128_si512(regs[0]);
+        lanes = _mm512_inserti32x4(lanes, regs[1], 1);
+        lanes = _mm512_inserti32x4(lanes, regs[2], 2);
+        lanes = _mm512_inserti32x4(lanes, regs[3], 3);
+        return(lanes);
+    }
+
+    SLD_HASH128_LANES_TARGET SLD_INLINE hash128_lanes_t
+    hash128_lanes_broadcast(
+        const __m128i reg) {
+
+        // the unmasked broadcast leaves gcc 12 warning about its undefined source,
+        // a full zeroing mask is the same instruction
+        return(_mm512_maskz_broadcast_i32x4((__mmask16)0xFFFF, reg));
+    }
+
+    SLD_HASH128_LANES_TARGET SLD_INLINE void
+    hash128_lanes_store(
+        const hash128_lanes_t& lanes,
+        hash128_t*             hashes) {
+
+        _mm512_storeu_si512((void*)hashes, lanes);
+    }
+
+#   include "sld-hash128-lanes.cpp"
+#   undef SLD_HASH128_LANES_TARGET
+    };
+
+    namespace hash128_lanes_256 {
+
+#   define SLD_HASH128_LANES_TARGET SLD_HASH128_TARGET_VAES_256
+
+    constexpr u32 HASH128_BATCH_LANE_COUNT = 2;
+
+    typedef __m256i hash128_lanes_t;
+
+    SLD_HASH128_LANES_TARGET SLD_INLINE void hash128_lanes_aesdec (hash128_lanes_t& a, const hash128_lanes_t& b) { a = _mm256_aesdec_epi128 (a, b); }
+    SLD_HASH128_LANES_TARGET SLD_INLINE void hash128_lanes_add    (hash128_lanes_t& a, const hash128_lanes_t& b) { a = _mm256_add_epi64    (a, b); }
+    SLD_HASH128_LANES_TARGET SLD_INLINE void hash128_lanes_xor    (hash128_lanes_t& a, const hash128_lanes_t& b) { a = _mm256_xor_si256    (a, b); }
+
+    SLD_HASH128_LANES_TARGET SLD_INLINE hash128_lanes_t hash128_lanes_bytes_1  (const hash128_lanes_t& high, const hash128_lanes_t& low) { return(_mm256_alignr_epi8(high, low, 1));  }
+    SLD_HASH128_LANES_TARGET SLD_INLINE hash128_lanes_t hash128_lanes_bytes_15 (const hash128_lanes_t& high, const hash128_lanes_t& low) { return(_mm256_alignr_epi8(high, low, 15)); }
+
+    SLD_HASH128_LANES_TARGET SLD_INLINE hash128_lanes_t
+    hash128_lanes_set(
+        const __m128i* regs) {
+
+        return(_mm256_set_m128i(regs[1], regs[0]));
+    }
+
+    SLD_HASH128_LANES_TARGET SLD_INLINE hash128_lanes_t
+    hash128_lanes_broadcast(
+        const __m128i reg) {
+
+        return(_mm256_broadcastsi128_si256(reg));
+    }
+
+    SLD_HASH128_LANES_TARGET SLD_INLINE void
+    hash128_lanes_store(
+        const hash128_lanes_t& lanes,
+        hash128_t*             hashes) {
+
+        _mm256_storeu_si256((__m256i*)hashes, lanes);
+    }
+
+#   include "sld-hash128-lanes.cpp"
+#   undef SLD_HASH128_LANES_TARGET
+    };
+
+    SLD_INTERNAL void
+    hash128_cpuid(
+        const u32 leaf,
+        const u32 subleaf,
+        u32*      regs) {
+
+    #if defined(_MSC_VER)
+        __cpuidex((int*)regs, (int)leaf, (int)subleaf);
+    #else
+        __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+    #endif
+    }
+
+    SLD_INTERNAL u64
+    hash128_xgetbv(
+        const u32 index) {
+
+    #if defined(_MSC_VER)
+        return((u64)_xgetbv(index));
+    #else
+        u32 low  = 0;
+        u32 high = 0;
+        __asm__ volatile ("xgetbv" : "=a"(low), "=d"(high) : "c"(index));
+        return(((u64)high << 32) | low);
+    #endif
+    }
+
+    // the cpu having the instructions isn't enough, the os has to be saving
+    // the ymm (and for avx512 the zmm and mask) registers too
+    SLD_INTERNAL hash128_batch_lanes_f
+    hash128_batch_lanes_select(
+        void) {
+
+        u32 leaf_0[4];
+        hash128_cpuid(0, 0, leaf_0);
+        if (leaf_0[0] < 7) return(NULL);
+
+        u32 leaf_1[4];
+        u32 leaf_7[4];
+        hash128_cpuid(1, 0, leaf_1);
+        hash128_cpuid(7, 0, leaf_7);
+
+        const bool has_xsave = (leaf_1[2] & (1u << 27)) != 0;
+        const u64  xcr0      = has_xsave ? hash128_xgetbv(0) : 0;
+
+        bool has_avx2 = true;
+        has_avx2 &= has_xsave;
+        has_avx2 &= (leaf_1[2] & (1u << 25)) != 0; // aes
+        has_avx2 &= (leaf_1[2] & (1u << 28)) != 0; // avx
+        has_avx2 &= (leaf_7[1] & (1u << 5))  != 0; // avx2
+        has_avx2 &= (leaf_7[2] & (1u << 9))  != 0; // vaes
+        has_avx2 &= (xcr0 & 0x06) == 0x06;         // xmm, ymm
+
+        bool has_avx512 = has_avx2;
+        has_avx512 &= (leaf_7[1] & (1u << 16)) != 0; // avx512f
+        has_avx512 &= (leaf_7[1] & (1u << 30)) != 0; // avx512bw
+        has_avx512 &= (xcr0 & 0xE0) == 0xE0;         // opmask, zmm
+
+        if (has_avx512) return(hash128_lanes_512::hash128_data_batch_lanes);
+        if (has_avx2)   return(hash128_lanes_256::hash128_data_batch_lanes);
+        return(NULL);
+    }
+
+    // NULL when there's no VAES, every key goes through MeowHash then
+    SLD_INTERNAL hash128_batch_lanes_f
+    hash128_batch_lanes_get(
+        void) {
+
+        static const hash128_batch_lanes_f batch_lanes = hash128_batch_lanes_select();
+        return(batch_lanes);
+    }
+
+    //-------------------------------------------------------------------
+    // HASH128
+    //-------------------------------------------------------------------
+
     SLD_API const hash128_t
     hash128_data(
         const hash128_seed_t& seed,
@@ -41,14 +239,26 @@ namespace sld {
         can_hash &= (out_hashes != NULL);
         
         if (can_hash) {
+
+            // walk the data with a pointer, index * stride overflows u32 past 4GB
+            const byte* element = in_data;
+            u32         index   = 0;
+
+            // small keys go through the lanes, what's left over one at a time
+            const hash128_batch_lanes_f batch_lanes = hash128_batch_lanes_get();
+            if (batch_lanes != NULL && in_stride < HASH128_BATCH_STRIDE_SMALL) {
+                index   = batch_lanes(in_seed, in_count, in_data, in_stride, out_hashes);
+                element = in_data + (u64)index * in_stride;
+            }
+
             for (
-                u32 index = 0;
+                ;
                 index < in_count;
                 ++index) {
 
-                const u32     offset   = index * in_stride;
-                const __m128i hash_reg = MeowHash((void*)in_seed.buffer, in_stride, (void*)&in_data[offset]);
+                const __m128i hash_reg = MeowHash((void*)in_seed.buffer, in_stride, (void*)element);
                 _mm_store_si128((__m128i*)&out_hashes[index], hash_reg);
+                element += in_stride;
             }
         }
 
@@ -57,32 +267,191 @@ namespace sld {
 
     SLD_API bool
     hash128_search(
-        const u32      in_count,
-        const hash128_t   in_search,
-        const hash128_t*  in_array,
-        u32&          out_index) {
+        const u32        in_count,
+        const hash128_t  in_search,
+        const hash128_t* in_array,
+        u32&             out_index) {
 
         bool can_search = true;
         can_search &= (in_count != 0);
         can_search &= (in_array != NULL);
         if (!can_search) return(can_search);
 
+        // a hash matches when both its u64 halves do, so after a 64 bit compare
+        // the match bits are the even bits whose odd neighbour is also set
+        u32 index = 0;
+
+    #if defined(__AVX512F__)
+        // 4 per step
+        const __m512i reg_search_512 = _mm512_maskz_broadcast_i32x4((__mmask16)0xFFFF, _mm_load_si128((const __m128i*)&in_search));
+        for (; (index + 4) <= in_count; index += 4) {
+
+            const __m512i reg   = _mm512_loadu_si512((const void*)&in_array[index]);
+            const u32     mask  = (u32)_mm512_cmpeq_epi64_mask(reg, reg_search_512);
+            const u32     match = (mask & (mask >> 1) & 0x55);
+            if (match != 0) {
+                out_index = index + (bit_scan_forward(match) >> 1);
+                return(true);
+            }
+        }
+    #elif defined(__AVX2__)
+        // 4 per step, two compares folded into one mask
+        const __m256i reg_search_256 = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)&in_search));
+        for (; (index + 4) <= in_count; index += 4) {
+
+            const __m256i reg_a  = _mm256_loadu_si256((const __m256i*)&in_array[index]);
+            const __m256i reg_b  = _mm256_loadu_si256((const __m256i*)&in_array[index + 2]);
+            const u32     mask_a = (u32)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(reg_a, reg_search_256)));
+            const u32     mask_b = (u32)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(reg_b, reg_search_256)));
+            const u32     mask   = (mask_a | (mask_b << 4));
+            const u32     match  = (mask & (mask >> 1) & 0x55);
+            if (match != 0) {
+                out_index = index + (bit_scan_forward(match) >> 1);
+                return(true);
+            }
+        }
+    #endif
+
         const meow_u128 meow_search = _mm_load_si128((meow_u128*)&in_search);
+        for (; index < in_count; ++index) {
+
+            const meow_u128 meow_current = _mm_load_si128((meow_u128*)&in_array[index]);
+            if (MeowHashesAreEqual(meow_search, meow_current)) {
+                out_index = index;
+                return(true);
+            }
+        }
 
-        bool is_found = false;
+        return(false);
+    }
+
+    SLD_API bool
+    hash128_search_split(
+        const u32       count,
+        const hash128_t search,
+        const u64*      array_low,
+        const u64*      array_high,
+        u32&            index) {
+
+        bool can_search = true;
+        can_search &= (count      != 0);
+        can_search &= (array_low  != NULL);
+        can_search &= (array_high != NULL);
+        if (!can_search) return(can_search);
+
+        // scan the low halves at full register width, the high half only gets
+        // checked on a low hit which for real hashes is almost always the match
+        const u64 search_low  = search.val.as_u64[0];
+        const u64 search_high = search.val.as_u64[1];
         for (
-            out_index = 0;
-            (
-                out_index    <  in_count &&
-                is_found == false
-            );
-            ++out_index) {
-
-            const meow_u128 meow_current = _mm_load_si128((meow_u128*)&in_array[out_index]);
-            is_found = MeowHashesAreEqual(meow_search, meow_current);
+            u32 start = 0;
+            start < count;
+            ) {
+
+            const u32 found = simd_search_u64(&array_low[start], count - start, search_low);
+            if (found == SIMD_SEARCH_INVALID_INDEX) break;
+
+            const u32 candidate = start + found;
+            if (array_high[candidate] == search_high) {
+                index = candidate;
+                return(true);
+            }
+            start = candidate + 1;
         }
 
-        return(is_found);
+        return(false);
+    }
+
+    SLD_API bool
+    hash128_search_sorted(
+        const u32        count,
+        const hash128_t  search,
+        const hash128_t* array,
+        u32&             index) {
+
+        bool can_search = true;
+        can_search &= (count != 0);
+        can_search &= (array != NULL);
+        if (!can_search) return(can_search);
+
+        // hashes are uniform so guessing the position from the low half lands close,
+        // a few of those and then plain halving so a skewed array is still log n
+        const u64 search_low = search.val.as_u64[0];
+        u32       low        = 0;
+        u32       high       = count - 1;
+        u32       step       = 0;
+
+        while (
+            low <= high                              &&
+            search_low >= array[low].val.as_u64[0]   &&
+            search_low <= array[high].val.as_u64[0]) {
+
+            const u64 value_low  = array[low].val.as_u64[0];
+            const u64 value_high = array[high].val.as_u64[0];
+
+            u32 middle = low + ((high - low) >> 1);
+            if (step < HASH128_SEARCH_INTERPOLATION_STEPS && value_high != value_low) {
+
+                const f64 position = (f64)(search_low - value_low) / (f64)(value_high - value_low);
+                middle = low + (u32)(position * (f64)(high - low));
+                middle = (middle > high) ? high : middle;
+                ++step;
+            }
+
+            const s32 compare = hash128_compare(array[middle], search);
+            if (compare == 0) {
+                index = middle;
+                return(true);
+            }
+
+            if (compare < 0) {
+                low = middle + 1;
+            }
+            else {
+                if (middle == 0) break;
+                high = middle - 1;
+            }
+        }
+
+        return(false);
+    }
+
+    SLD_API void
+    hash128_split(
+        const u32        count,
+        const hash128_t* array,
+        u64*             array_low,
+        u64*             array_high) {
+
+        assert(
+            (array      != NULL &&
+             array_low  != NULL &&
+             array_high != NULL) || count == 0
+        );
+
+        for (
+            u32 index = 0;
+            index < count;
+            ++index) {
+
+            array_low  [index] = array[index].val.as_u64[0];
+            array_high [index] = array[index].val.as_u64[1];
+        }
+    }
+
+    SLD_API s32
+    hash128_compare(
+        const hash128_t& hash_a,
+        const hash128_t& hash_b) {
+
+        const u64 a_low  = hash_a.val.as_u64[0];
+        const u64 b_low  = hash_b.val.as_u64[0];
+        const u64 a_high = hash_a.val.as_u64[1];
+        const u64 b_high = hash_b.val.as_u64[1];
+
+        if (a_low  != b_low)  return((a_low  < b_low)  ? -1 : 1);
+        if (a_high != b_high) return((a_high < b_high) ? -1 : 1);
+        return(0);
     }
 
     SLD_API bool
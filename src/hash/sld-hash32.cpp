@@ -3,6 +3,7 @@
 #include <zlib-ng.h>
 
 #include "sld-hash.hpp"
+#include "sld-simd.hpp"
 
 namespace sld {
 
@@ -35,13 +36,14 @@ namespace sld {
 
         if (can_hash) {
 
+            const byte* element = data;
             for (
                 u32 index = 0;
                 index < count;
                 ++index) {
 
-                const u32 offset     = index * stride; 
-                hashes[index].as_u32 = zng_crc32(seed.val, &data[offset], stride);
+                hashes[index].as_u32 = zng_crc32(seed.val, element, stride);
+                element += stride;
             }
         }
         return(can_hash);
@@ -74,19 +76,18 @@ namespace sld {
         const hash32_t* array,
         u32&            index) {
 
-        //TODO: SIMD
-
         bool is_found   = false;
         bool can_search = true;
         can_search &= (count != 0);
         can_search &= (array != NULL);
         if (can_search) {
-            for (
-                index = 0;
-                (index < count) && !is_found;
-                ++index) {
 
-                is_found = (search.as_u32 == array[index].as_u32);
+            static_assert(sizeof(hash32_t) == sizeof(u32), "hash32_t has to be a plain u32 to search it as one");
+
+            const u32 found_index = simd_search_u32((const u32*)array, count, search.as_u32);
+            is_found = (found_index != SIMD_SEARCH_INVALID_INDEX);
+            if (is_found) {
+                index = found_index;
             }
         }
 
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <ucontext.h>
+
+#include "sld-linux.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // GLOBALS
+    //-------------------------------------------------------------------
+
+    // the context a thread saves into when it switches away as a fiber
+    SLD_GLOBAL thread_local ucontext_t _linux_fiber_thread_context;
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    struct linux_fiber_start_t {
+        os_fiber_function_f function;
+        void*               data;
+    };
+
+    SLD_API_OS_INTERNAL void
+    linux_fiber_proc(
+        const u32 start_high,
+        const u32 start_low) {
+
+        // makecontext only passes ints, the start pointer comes in two halves
+        const u64            start_addr = ((u64)start_high << 32) | (u64)start_low;
+        linux_fiber_start_t* start      = (linux_fiber_start_t*)start_addr;
+
+        start->function(start->data);
+
+        // fibers don't return, there's nowhere to go
+        panic;
+    }
+
+    //-------------------------------------------------------------------
+    // FIBER
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_FUNC bool
+    linux_fiber_create(
+        os_fiber&           fiber,
+        void*               stack,
+        const u64           stack_size,
+        os_fiber_function_f function,
+        void*               data) {
+
+        // the context and start data go at the top of the stack, the fiber
+        // stack grows down from under them
+        const u64 size_header = size_align_pow_2(sizeof(ucontext_t) + sizeof(linux_fiber_start_t), 64);
+
+        bool can_create = true;
+        can_create &= (stack      != NULL);
+        can_create &= (function   != NULL);
+        can_create &= (stack_size >  (size_header * 2));
+        if (!can_create) return(can_create);
+
+        const addr           header_start = ((addr)stack + stack_size - size_header) & ~(addr)63;
+        ucontext_t*          context      = (ucontext_t*)header_start;
+        linux_fiber_start_t* start        = (linux_fiber_start_t*)(header_start + sizeof(ucontext_t));
+
+        start->function = function;
+        start->data     = data;
+
+        if (getcontext(context) != 0) return(false);
+        context->uc_stack.ss_sp   = stack;
+        context->uc_stack.ss_size = (u64)(header_start - (addr)stack);
+        context->uc_link          = NULL;
+
+        const u64 start_addr = (u64)start;
+        makecontext(
+            context,
+            (void (*)(void))linux_fiber_proc,
+            2,
+            (u32)(start_addr >> 32),
+            (u32)(start_addr & 0xFFFFFFFF)
+        );
+
+        fiber.os_handle = context;
+        return(true);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_fiber_destroy(
+        os_fiber& fiber) {
+
+        // everything lives in the stack memory, the caller owns that
+        fiber.os_handle = NULL;
+        return(true);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_fiber_from_thread(
+        os_fiber& fiber) {
+
+        fiber.os_handle = &_linux_fiber_thread_context;
+        return(true);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_fiber_to_thread(
+        os_fiber& fiber) {
+
+        const bool is_thread = (fiber.os_handle == &_linux_fiber_thread_context);
+        fiber.os_handle = NULL;
+        return(is_thread);
+    }
+
+    SLD_API_OS_FUNC void
+    linux_fiber_switch(
+        os_fiber& fiber_from,
+        os_fiber& fiber_to) {
+
+        // NOTE(SAM): swapcontext also saves and restores the signal mask, which is a
+        // syscall each way. it's fine at the rate jobs wait, if it shows up we
+        // can replace it with a register-only switch
+        const s32 result = swapcontext((ucontext_t*)fiber_from.os_handle, (ucontext_t*)fiber_to.os_handle);
+        assert(result == 0);
+    }
+};
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <errno.h>
+#include <sys/stat.h>
+
+#include "sld-linux.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    // os_file_handle is a pointer and NULL is invalid, fd 0 is a real file
+    // so handles hold the fd plus one
+    SLD_API_OS_INTERNAL s32
+    linux_file_get_fd(
+        const os_file_handle file_hnd) {
+
+        return((s32)((addr)file_hnd - 1));
+    }
+
+    SLD_API_OS_INTERNAL os_file_handle
+    linux_file_handle_from_fd(
+        const s32 fd) {
+
+        return((os_file_handle)((addr)fd + 1));
+    }
+
+    SLD_API_OS_INTERNAL void
+    linux_file_set_last_error(
+        void) {
+
+        switch (errno) {
+            case (0):         { _last_error_file = os_file_error_success;           } break;
+            case (EINVAL):    { _last_error_file = os_file_error_invalid_args;      } break;
+            case (EBADF):     { _last_error_file = os_file_error_invalid_handle;    } break;
+            case (ENODEV):    { _last_error_file = os_file_error_invalid_device;    } break;
+            case (ENXIO):     { _last_error_file = os_file_error_invalid_device;    } break;
+            case (EFAULT):    { _last_error_file = os_file_error_invalid_buffer;    } break;
+            case (EISDIR):    { _last_error_file = os_file_error_invalid_file;      } break;
+            case (ETXTBSY):   { _last_error_file = os_file_error_sharing_violation; } break;
+            case (EEXIST):    { _last_error_file = os_file_error_already_exists;    } break;
+            case (ENOENT):    { _last_error_file = os_file_error_not_found;         } break;
+            case (EACCES):    { _last_error_file = os_file_error_access_denied;     } break;
+            case (EPERM):     { _last_error_file = os_file_error_access_denied;     } break;
+            case (EPIPE):     { _last_error_file = os_file_error_broken_pipe;       } break;
+            case (EAGAIN):    { _last_error_file = os_file_error_io_pending;        } break;
+            case (ECANCELED): { _last_error_file = os_file_error_operation_aborted; } break;
+            case (EIO):       { _last_error_file = os_file_error_disk_io_failure;   } break;
+            case (ENOMEM):    { _last_error_file = os_file_error_out_of_memory;     } break;
+            default:          { _last_error_file = os_file_error_unknown;           } break;
+        }
+    }
+
+    SLD_API_OS_INTERNAL void
+    linux_file_clear_last_error(
+        void) {
+
+        _last_error_file = os_file_error_success;
+    }
+
+    SLD_API_OS_INTERNAL bool
+    linux_file_map_view_prot(
+        const os_file_map_handle map_hnd,
+        const u64                offset,
+        const u64                size,
+        const s32                prot,
+        os_file_mapped_buffer*   view) {
+
+        static const u64 granularity = linux_memory_get_page_size();
+        assert(
+            map_hnd != NULL &&
+            view    != NULL &&
+            size    != 0    &&
+            (offset & (granularity - 1)) == 0
+        );
+        linux_file_clear_last_error();
+
+        void* file_data = mmap(
+            NULL,
+            size,
+            prot,
+            MAP_SHARED,
+            linux_file_get_fd((os_file_handle)map_hnd),
+            (off_t)offset
+        );
+        if (file_data == MAP_FAILED) {
+            linux_file_set_last_error();
+            return(false);
+        }
+
+        view->map_handle = map_hnd;
+        view->data       = (byte*)file_data;
+        view->size       = size;
+        view->offset     = offset;
+        view->cursor     = 0;
+        return(true);
+    }
+
+    //-------------------------------------------------------------------
+    // FILE
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_FUNC os_file_error
+    linux_file_get_last_error(
+        void) {
+
+        return(_last_error_file);
+    }
+
+    SLD_API_OS_FUNC os_file_handle
+    linux_file_open(
+        const os_file_config* config) {
+
+        constexpr u32 create_mode_count = 4;
+        assert(
+            config &&
+            config->mode < create_mode_count
+        );
+        linux_file_clear_last_error();
+
+        // access
+        const bool is_read  = config->access_flags.test(os_file_access_flag_read);
+        const bool is_write = config->access_flags.test(os_file_access_flag_write);
+        s32 flags = O_CLOEXEC;
+        flags |= (is_read && is_write) ? O_RDWR : (is_write ? O_WRONLY : O_RDONLY);
+
+        // mode, sharing has no equivalent here
+        constexpr s32 create_mode_array[create_mode_count] = {
+            O_CREAT | O_EXCL,  // os_file_mode_create_new
+            0,                 // os_file_mode_open_existing
+            O_CREAT,           // os_file_mode_open_always
+            O_CREAT | O_TRUNC  // os_file_mode_overwrite_existing
+        };
+        flags |= create_mode_array[config->mode];
+
+        // the async functions aren't on linux yet, is_async is ignored
+        static const mode_t file_permissions = 0644;
+        const s32 fd = open(config->path, flags, file_permissions);
+        if (fd < 0) {
+            linux_file_set_last_error();
+            return(OS_FILE_HANDLE_INVALID);
+        }
+
+        return(linux_file_handle_from_fd(fd));
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_file_close(
+        const os_file_handle file_hnd) {
+
+        assert(file_hnd);
+        linux_file_clear_last_error();
+
+        const bool did_close = (close(linux_file_get_fd(file_hnd)) == 0);
+        if (!did_close) {
+            linux_file_set_last_error();
+        }
+        return(did_close);
+    }
+
+    SLD_API_OS_FUNC u64
+    linux_file_get_size(
+        const os_file_handle file_hnd) {
+
+        assert(file_hnd);
+        linux_file_clear_last_error();
+
+        struct stat file_stat;
+        const bool did_get_size = (fstat(linux_file_get_fd(file_hnd), &file_stat) == 0);
+        if (!did_get_size) {
+            linux_file_set_last_error();
+            return(OS_FILE_SIZE_INVALID);
+        }
+        return((u64)file_stat.st_size);
+    }
+
+    //-------------------------------------------------------------------
+    // MAP
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_FUNC u64
+    linux_file_map_get_granularity(
+        void) {
+
+        return(linux_memory_get_page_size());
+    }
+
+    SLD_API_OS_FUNC os_file_map_handle
+    linux_file_map_create(
+        const os_file_handle file_hnd) {
+
+        // there's no mapping object, views map straight from the file
+        assert(file_hnd);
+        linux_file_clear_last_error();
+        return((os_file_map_handle)file_hnd);
+    }
+
+    SLD_API_OS_FUNC os_file_map_handle
+    linux_file_map_create_writable(
+        const os_file_handle file_hnd,
+        const u64            size) {
+
+        assert(file_hnd);
+        linux_file_clear_last_error();
+
+        struct stat file_stat;
+        const s32 fd = linux_file_get_fd(file_hnd);
+        if (fstat(fd, &file_stat) != 0) {
+            linux_file_set_last_error();
+            return(NULL);
+        }
+
+        // the new end reads as zeros and stays sparse until written
+        if ((u64)file_stat.st_size < size && ftruncate(fd, (off_t)size) != 0) {
+            linux_file_set_last_error();
+            return(NULL);
+        }
+
+        return((os_file_map_handle)file_hnd);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_file_map_destroy(
+        const os_file_map_handle map_hnd) {
+
+        assert(map_hnd);
+        linux_file_clear_last_error();
+        return(true);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_file_map_view(
+        const os_file_map_handle map_hnd,
+        const u64                offset,
+        const u64                size,
+        os_file_mapped_buffer*   view) {
+
+        const bool is_mapped = linux_file_map_view_prot(map_hnd, offset, size, PROT_READ, view);
+
+        // read views are streamed front to back, this doubles the kernel's read
+        // ahead and lets it drop pages behind us sooner
+        if (is_mapped) (void)madvise(view->data, view->size, MADV_SEQUENTIAL);
+        return(is_mapped);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_file_map_view_writable(
+        const os_file_map_handle map_hnd,
+        const u64                offset,
+        const u64                size,
+        os_file_mapped_buffer*   view) {
+
+        return(linux_file_map_view_prot(map_hnd, offset, size, PROT_READ | PROT_WRITE, view));
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_file_map_unview(
+        os_file_mapped_buffer* view) {
+
+        assert(view != NULL && view->data != NULL);
+        linux_file_clear_last_error();
+
+        const bool is_unmapped = (munmap(view->data, view->size) == 0);
+        if (!is_unmapped) {
+            linux_file_set_last_error();
+            return(is_unmapped);
+        }
+
+        view->data   = NULL;
+        view->size   = 0;
+        view->offset = 0;
+        view->cursor = 0;
+        return(is_unmapped);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_file_map_prefetch(
+        const os_file_mapped_buffer* view) {
+
+        assert(view != NULL && view->data != NULL);
+
+        // only a hint, starts the reads and returns without waiting
+        const bool is_prefetching = (madvise(view->data, view->size, MADV_WILLNEED) == 0);
+        return(is_prefetching);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_file_map_flush(
+        const os_file_mapped_buffer* view) {
+
+        assert(view != NULL && view->data != NULL);
+        linux_file_clear_last_error();
+
+        const bool is_flushed = (msync(view->data, view->size, MS_SYNC) == 0);
+        if (!is_flushed) {
+            linux_file_set_last_error();
+        }
+        return(is_flushed);
+    }
+};
@@ -0,0 +1,332 @@
+#pragma once
+
+#include "sld-linux.hpp"
+
+namespace sld {
+
+    SLD_API_OS_INTERNAL const u64
+    linux_memory_get_page_size(
+        void) {
+
+        static u64 page_size = 0;
+
+        if (page_size == 0) {
+            const long result = sysconf(_SC_PAGESIZE);
+            page_size = (result > 0) ? (u64)result : 4096;
+        }
+
+        assert(page_size != 0);
+        return(page_size);
+    }
+
+    SLD_API_OS_FUNC void*
+    linux_memory_alloc(
+        const u64 size) {
+
+        assert(size != 0);
+
+        // NOTE(SAM): munmap needs the size, so we keep it in a header page
+        // in front of the allocation to keep the same api as VirtualFree
+        const u64 page_size  = linux_memory_get_page_size();
+        const u64 size_total = size_align_pow_2(size, page_size) + page_size;
+
+        void* base = mmap(
+            NULL,                        // no starting address
+            size_total,                  // size
+            PROT_READ | PROT_WRITE,      // protection
+            MAP_PRIVATE | MAP_ANONYMOUS, // type
+            -1,                          // no file
+            0                            // no offset
+        );
+        if (base == MAP_FAILED) return(NULL);
+
+        *(u64*)base = size_total;
+
+        void* mem = (void*)((addr)base + page_size);
+        return(mem);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_memory_free(
+        void* start) {
+
+        assert(start != NULL);
+
+        const u64  page_size  = linux_memory_get_page_size();
+        void*      base       = (void*)((addr)start - page_size);
+        const u64  size_total = *(u64*)base;
+        const bool is_free    = (munmap(base, size_total) == 0);
+
+        return(is_free);
+    }
+
+    SLD_API_OS_FUNC void*
+    linux_memory_reserve(
+        void*     start,
+        const u64 size) {
+
+        void* memory = mmap(
+            start,
+            size,
+            PROT_NONE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+            -1,
+            0
+        );
+        if (memory == MAP_FAILED) return(NULL);
+
+        // the address is only a hint for mmap, VirtualAlloc fails instead
+        if (start != NULL && memory != start) {
+            (void)munmap(memory, size);
+            return(NULL);
+        }
+
+        return(memory);
+    }
+
+    SLD_API_OS_FUNC void*
+    linux_memory_reserve_large(
+        void*     start,
+        const u64 size) {
+
+        // NOTE(SAM): we ask for transparent huge pages rather than MAP_HUGETLB, hugetlb
+        // pages come from a fixed pool and touching a committed page with the pool
+        // empty raises SIGBUS instead of failing the commit
+        const u64 large_page_size = linux_memory_get_large_page_size();
+        const u64 size_aligned    = size_align_pow_2(size, large_page_size);
+
+        // a fixed start has to be on a large page already, VirtualAlloc with
+        // MEM_LARGE_PAGES fails the same way. we can't move it and padding would run past it
+        const bool is_start_aligned = (((addr)start & (large_page_size - 1)) == 0);
+        if (!is_start_aligned) return(NULL);
+
+        // over-reserve by a large page so the range can be aligned to one
+        const u64 size_padded = (start == NULL) ? (size_aligned + large_page_size) : size_aligned;
+        void*     padded      = linux_memory_reserve(start, size_padded);
+        if (!padded) return(NULL);
+
+        // trim the unaligned head and tail
+        const addr padded_start = (addr)padded;
+        const addr memory_start = (addr)size_align_pow_2(padded_start, large_page_size);
+        const addr memory_end   = memory_start + size_aligned;
+        const addr padded_end   = padded_start + size_padded;
+        if (memory_start > padded_start) (void)munmap((void*)padded_start, memory_start - padded_start);
+        if (padded_end   > memory_end)   (void)munmap((void*)memory_end,   padded_end   - memory_end);
+
+        // if THP is disabled this fails and the range just uses regular pages
+        (void)madvise((void*)memory_start, size_aligned, MADV_HUGEPAGE);
+
+        return((void*)memory_start);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_memory_release(
+        void*     start,
+        const u64 size) {
+
+        const bool result = (munmap(start, size) == 0);
+        return(result);
+    }
+
+    SLD_API_OS_FUNC void*
+    linux_memory_commit(
+        void*     start,
+        const u64 size) {
+
+        assert(start != NULL && size != 0);
+
+        // mprotect works on whole pages
+        const u64  page_size    = linux_memory_get_page_size();
+        const addr commit_start = (addr)start & ~(addr)(page_size - 1);
+        const u64  commit_size  = size_align_pow_2(((addr)start + size) - commit_start, page_size);
+
+        const bool is_committed = (mprotect((void*)commit_start, commit_size, PROT_READ | PROT_WRITE) == 0);
+        void*      memory       = is_committed ? start : NULL;
+        return(memory);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_memory_decommit(
+        void*     start,
+        const u64 size) {
+
+        assert(start != NULL && size != 0);
+
+        const u64  page_size      = linux_memory_get_page_size();
+        const addr decommit_start = (addr)start & ~(addr)(page_size - 1);
+        const u64  decommit_size  = size_align_pow_2(((addr)start + size) - decommit_start, page_size);
+
+        // NOTE(SAM): MADV_FREE is cheaper but the old contents can survive until the
+        // kernel reclaims them, and a recommit has to read back as zero like MEM_COMMIT
+        bool result = true;
+        result &= (madvise  ((void*)decommit_start, decommit_size, MADV_DONTNEED) == 0);
+        result &= (mprotect ((void*)decommit_start, decommit_size, PROT_NONE)     == 0);
+        return(result);
+    }
+
+    SLD_API_OS_FUNC u64
+    linux_memory_align_to_page(
+        const u64 size) {
+
+        static const u64 page_size = linux_memory_get_page_size();
+
+        const u64 size_aligned = size_align_pow_2(size, page_size);
+        return(size_aligned);
+    }
+
+    SLD_API_OS_FUNC u64
+    linux_memory_align_to_granularity(
+        const u64 size) {
+
+        // mmap has no allocation granularity beyond the page size
+        static const u64 granularity = linux_memory_get_page_size();
+
+        const u64 size_aligned = size_align_pow_2(size, granularity);
+        return(size_aligned);
+    }
+
+    SLD_API_OS_FUNC u64
+    linux_memory_align_to_large_page(
+        const u64 size) {
+
+        static const u64 large_page_size = linux_memory_get_large_page_size();
+
+        const u64 size_aligned = size_align_pow_2(size, large_page_size);
+        return(size_aligned);
+    }
+
+    SLD_API_OS_FUNC u64
+    linux_memory_get_large_page_size(
+        void) {
+
+        static u64 large_page_size = 0;
+
+        if (large_page_size == 0) {
+
+            // the PMD size is the huge page THP will use, 2MB on x64
+            large_page_size = size_megabytes(2);
+
+            cchar      text[32] = {0};
+            const s32  file     = open("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", O_RDONLY);
+            if (file >= 0) {
+
+                const ssize_t length = read(file, text, sizeof(text) - 1);
+                if (length > 0) {
+
+                    u64 value = 0;
+                    for (
+                        u32 index = 0;
+                        index < (u32)length && text[index] >= '0' && text[index] <= '9';
+                        ++index) {
+
+                        value = (value * 10) + (text[index] - '0');
+                    }
+                    if (size_is_pow_2(value)) {
+                        large_page_size = value;
+                    }
+                }
+                (void)close(file);
+            }
+        }
+
+        return(large_page_size);
+    }
+
+    SLD_INTERNAL u64
+    linux_memory_hex_digit(
+        const cchar c) {
+
+        if (c >= '0' && c <= '9') return(c - '0');
+        if (c >= 'a' && c <= 'f') return(c - 'a' + 10);
+        return(0);
+    }
+
+    // NOTE(SAM): linux has no reserved/committed state to query, but reserve maps
+    // PROT_NONE and commit makes it read/write, so the protection on the mapping
+    // the page is in says which. residency (mincore) won't do, a committed page
+    // isn't resident until it's touched. false if the address isn't mapped at all
+    SLD_INTERNAL bool
+    linux_memory_get_access(
+        void* start,
+        bool& is_accessible) {
+
+        const s32 file = open("/proc/self/maps", O_RDONLY);
+        if (file < 0) return(false);
+
+        // every line starts "begin-end perms ", we parse those and skip the
+        // rest. it's read in chunks so a line can straddle two reads
+        const addr address        = (addr)start;
+        cchar      text[4096];
+        u32        field          = 0;
+        addr       begin          = 0;
+        addr       end            = 0;
+        bool       is_line_access = false;
+        bool       is_found       = false;
+
+        ssize_t length = 0;
+        while (!is_found && (length = read(file, text, sizeof(text))) > 0) {
+
+            for (
+                ssize_t index = 0;
+                index < length && !is_found;
+                ++index) {
+
+                const cchar c = text[index];
+                if (c == '\n') {
+                    field          = 0;
+                    begin          = 0;
+                    end            = 0;
+                    is_line_access = false;
+                    continue;
+                }
+
+                switch (field) {
+                    case (0): {
+                        if (c == '-') field = 1;
+                        else          begin = (begin << 4) | linux_memory_hex_digit(c);
+                    } break;
+                    case (1): {
+                        if (c == ' ') field = 2;
+                        else          end   = (end << 4) | linux_memory_hex_digit(c);
+                    } break;
+                    case (2): {
+                        if (c == ' ') {
+                            field    = 3;
+                            is_found = (address >= begin && address < end);
+                        }
+                        is_line_access |= (c == 'r' || c == 'w' || c == 'x');
+                    } break;
+                    default: break;
+                }
+            }
+        }
+        (void)close(file);
+
+        is_accessible = is_found && is_line_access;
+        return(is_found);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_memory_is_reserved(
+        void* start) {
+
+        if (!start) return(false);
+
+        bool       is_accessible = false;
+        const bool is_mapped     = linux_memory_get_access(start, is_accessible);
+        const bool is_reserved   = is_mapped && !is_accessible;
+        return(is_reserved);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_memory_is_committed(
+        void* start) {
+
+        if (!start) return(false);
+
+        bool       is_accessible = false;
+        const bool is_mapped     = linux_memory_get_access(start, is_accessible);
+        const bool is_committed  = is_mapped && is_accessible;
+        return(is_committed);
+    }
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <time.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sld-linux.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_INTERNAL u32
+    linux_system_count_cpu_list(
+        const cchar* list) {
+
+        // counts a sysfs cpu list like "0-3,8,10-11"
+        u32 count = 0;
+        while (*list >= '0' && *list <= '9') {
+
+            u32 first = (u32)strtoul(list, (char**)&list, 10);
+            u32 last  = first;
+            if (*list == '-') last = (u32)strtoul(list + 1, (char**)&list, 10);
+
+            count += (last >= first) ? (last - first + 1) : 0;
+            if (*list == ',') ++list;
+        }
+        return(count);
+    }
+
+    //-------------------------------------------------------------------
+    // SYSTEM
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_FUNC void
+    linux_system_get_cpu_info(
+        os_system_cpu_info& cpu_info) {
+
+        cpu_info.parent_core_number  = 0;
+        cpu_info.speed_mhz           = 0;
+        cpu_info.cache_levels        = 0;
+        cpu_info.core_count_logical  = 0;
+        cpu_info.core_count_physical = 0;
+
+        // logical cores are the ones this process is allowed to run on, which is
+        // less than what's online inside a container or under taskset
+        cpu_set_t cpu_set;
+        if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+            cpu_info.core_count_logical = (u32)CPU_COUNT(&cpu_set);
+        }
+        if (cpu_info.core_count_logical == 0) {
+            const long result = sysconf(_SC_NPROCESSORS_ONLN);
+            cpu_info.core_count_logical = (result > 0) ? (u32)result : 1;
+        }
+
+        // physical cores from how many hardware threads share cpu0's core
+        u32   threads_per_core = 1;
+        FILE* file             = fopen("/sys/devices/system/cpu/cpu0/topology/thread_siblings_list", "r");
+        if (file) {
+            cchar list[64];
+            if (fgets(list, sizeof(list), file)) {
+                const u32 count = linux_system_count_cpu_list(list);
+                threads_per_core = (count != 0) ? count : 1;
+            }
+            fclose(file);
+        }
+
+        cpu_info.core_count_physical = cpu_info.core_count_logical / threads_per_core;
+        if (cpu_info.core_count_physical == 0) cpu_info.core_count_physical = 1;
+    }
+
+    SLD_API_OS_FUNC const u64
+    linux_system_time_ms(
+        void) {
+
+        timespec time_now;
+        clock_gettime(CLOCK_MONOTONIC, &time_now);
+
+        const u64 time_ms = ((u64)time_now.tv_sec * 1000) + ((u64)time_now.tv_nsec / 1000000);
+        return(time_ms);
+    }
+
+    SLD_API_OS_FUNC void
+    linux_system_sleep(
+        const u32 ms) {
+
+        linux_thread_sleep(ms);
+    }
+};
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <new>
+#include <time.h>
+#include <errno.h>
+#include <sched.h>
+#include <limits.h>
+#include <string.h>
+#include <pthread.h>
+#include <immintrin.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <atomic>
+
+#include "sld-linux.hpp"
+
+namespace sld {
+
+    static_assert(sizeof(pthread_t)        <= sizeof(vptr), "pthread_t doesn't fit in os_thread");
+    static_assert(sizeof(std::atomic<u32>) <= sizeof(vptr), "futex word doesn't fit in os_thread_mutex");
+
+    // NOTE(SAM): the mutex is the three state futex lock from drepper's "futexes are
+    // tricky", 0 unlocked, 1 locked, 2 locked with waiters. unlock only makes the
+    // syscall when someone might be waiting, and lock spins a little before sleeping
+    // since most of our critical sections are shorter than a trip through the kernel.
+    // the condition is a sequence number, waiters sleep until it changes
+    constexpr u32 LINUX_THREAD_MUTEX_UNLOCKED    = 0;
+    constexpr u32 LINUX_THREAD_MUTEX_LOCKED      = 1;
+    constexpr u32 LINUX_THREAD_MUTEX_CONTENDED   = 2;
+    constexpr u32 LINUX_THREAD_MUTEX_SPIN_COUNT  = 100;
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_INTERNAL std::atomic<u32>*
+    linux_thread_futex_word(
+        vptr& os_handle) {
+
+        return((std::atomic<u32>*)&os_handle);
+    }
+
+    SLD_API_OS_INTERNAL void
+    linux_thread_futex_wait(
+        std::atomic<u32>* word,
+        const u32         value) {
+
+        // returns straight away if the word isn't value anymore
+        (void)syscall(SYS_futex, (u32*)word, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+    }
+
+    SLD_API_OS_INTERNAL void
+    linux_thread_futex_wake(
+        std::atomic<u32>* word,
+        const s32         count) {
+
+        (void)syscall(SYS_futex, (u32*)word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+    }
+
+    SLD_API_OS_INTERNAL void*
+    linux_thread_proc(
+        void* param) {
+
+        os_thread_context* context = (os_thread_context*)param;
+        context->function(*context);
+        return(NULL);
+    }
+
+    //-------------------------------------------------------------------
+    // THREAD
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_FUNC bool
+    linux_thread_create(
+        os_thread&         thread,
+        os_thread_context& context) {
+
+        if (context.function == NULL) return(false);
+
+        pthread_t  handle     = 0;
+        const bool is_created = (pthread_create(&handle, NULL, linux_thread_proc, &context) == 0);
+
+        thread.os_handle = is_created ? (vptr)handle : NULL;
+        return(is_created);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_thread_join(
+        os_thread& thread) {
+
+        if (thread.os_handle == NULL) return(false);
+
+        const bool is_joined = (pthread_join((pthread_t)thread.os_handle, NULL) == 0);
+        thread.os_handle = NULL;
+        return(is_joined);
+    }
+
+    SLD_API_OS_FUNC void
+    linux_thread_get_current(
+        os_thread& thread) {
+
+        thread.os_handle = (vptr)pthread_self();
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_thread_set_name(
+        os_thread&   thread,
+        const cchar* name) {
+
+        if (thread.os_handle == NULL || name == NULL) return(false);
+
+        // pthread fails names over 15 characters instead of cutting them
+        cchar name_short[OS_THREAD_NAME_SIZE_MAX];
+        strncpy(name_short, name, OS_THREAD_NAME_SIZE_MAX - 1);
+        name_short[OS_THREAD_NAME_SIZE_MAX - 1] = 0;
+
+        const bool is_named = (pthread_setname_np((pthread_t)thread.os_handle, name_short) == 0);
+        return(is_named);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_thread_set_affinity(
+        os_thread& thread,
+        const u32  core_index) {
+
+        if (thread.os_handle == NULL || core_index >= CPU_SETSIZE) return(false);
+
+        // the index counts the cpus we're allowed on, under taskset or a cgroup
+        // cpu N might not be one of them
+        cpu_set_t cpu_set_allowed;
+        if (sched_getaffinity(0, sizeof(cpu_set_allowed), &cpu_set_allowed) != 0) return(false);
+
+        s32 cpu       = -1;
+        u32 cpu_count = 0;
+        for (
+            s32 cpu_index = 0;
+            cpu_index < CPU_SETSIZE && cpu < 0;
+            ++cpu_index) {
+
+            if (!CPU_ISSET(cpu_index, &cpu_set_allowed)) continue;
+            if (cpu_count == core_index) cpu = cpu_index;
+            ++cpu_count;
+        }
+        if (cpu < 0) return(false);
+
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(cpu, &cpu_set);
+
+        const bool is_pinned = (pthread_setaffinity_np((pthread_t)thread.os_handle, sizeof(cpu_set), &cpu_set) == 0);
+        return(is_pinned);
+    }
+
+    SLD_API_OS_FUNC void
+    linux_thread_yield(
+        void) {
+
+        (void)sched_yield();
+    }
+
+    SLD_API_OS_FUNC void
+    linux_thread_sleep(
+        const u32 ms) {
+
+        timespec time_remaining;
+        time_remaining.tv_sec  = (ms / 1000);
+        time_remaining.tv_nsec = (ms % 1000) * 1000000;
+
+        // signals cut the sleep short, keep going with what's left
+        while (nanosleep(&time_remaining, &time_remaining) == -1 && errno == EINTR) { }
+    }
+
+    //-------------------------------------------------------------------
+    // MUTEX
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_FUNC bool
+    linux_thread_mutex_create(
+        os_thread_mutex& mutex) {
+
+        mutex.os_handle = NULL;
+        new (&mutex.os_handle) std::atomic<u32>(LINUX_THREAD_MUTEX_UNLOCKED);
+        return(true);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_thread_mutex_destroy(
+        os_thread_mutex& mutex) {
+
+        // futexes are just memory
+        std::atomic<u32>* word = linux_thread_futex_word(mutex.os_handle);
+        assert(word->load(std::memory_order_relaxed) == LINUX_THREAD_MUTEX_UNLOCKED);
+
+        mutex.os_handle = NULL;
+        return(true);
+    }
+
+    SLD_API_OS_FUNC void
+    linux_thread_mutex_lock(
+        os_thread_mutex& mutex) {
+
+        std::atomic<u32>* word  = linux_thread_futex_word(mutex.os_handle);
+        u32               state = LINUX_THREAD_MUTEX_UNLOCKED;
+        if (word->compare_exchange_strong(state, LINUX_THREAD_MUTEX_LOCKED, std::memory_order_acquire)) return;
+
+        // spin while the owner is likely to let go soon, only reading so the
+        // cache line isn't bounced around until it looks free
+        for (
+            u32 spin = 0;
+            spin < LINUX_THREAD_MUTEX_SPIN_COUNT;
+            ++spin) {
+
+            _mm_pause();
+            state = word->load(std::memory_order_relaxed);
+            if (state == LINUX_THREAD_MUTEX_UNLOCKED &&
+                word->compare_exchange_weak(state, LINUX_THREAD_MUTEX_LOCKED, std::memory_order_acquire)) {
+                return;
+            }
+            if (state == LINUX_THREAD_MUTEX_CONTENDED) break;
+        }
+
+        // mark it contended so the owner wakes us, and sleep until we get it.
+        // once we've slept we always take it as contended since others might be waiting too
+        state = word->exchange(LINUX_THREAD_MUTEX_CONTENDED, std::memory_order_acquire);
+        while (state != LINUX_THREAD_MUTEX_UNLOCKED) {
+            linux_thread_futex_wait(word, LINUX_THREAD_MUTEX_CONTENDED);
+            state = word->exchange(LINUX_THREAD_MUTEX_CONTENDED, std::memory_order_acquire);
+        }
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_thread_mutex_try_lock(
+        os_thread_mutex& mutex) {
+
+        std::atomic<u32>* word      = linux_thread_futex_word(mutex.os_handle);
+        u32               state     = LINUX_THREAD_MUTEX_UNLOCKED;
+        const bool        is_locked = word->compare_exchange_strong(state, LINUX_THREAD_MUTEX_LOCKED, std::memory_order_acquire);
+        return(is_locked);
+    }
+
+    SLD_API_OS_FUNC void
+    linux_thread_mutex_unlock(
+        os_thread_mutex& mutex) {
+
+        std::atomic<u32>* word  = linux_thread_futex_word(mutex.os_handle);
+        const u32         state = word->exchange(LINUX_THREAD_MUTEX_UNLOCKED, std::memory_order_release);
+        assert(state != LINUX_THREAD_MUTEX_UNLOCKED);
+
+        if (state == LINUX_THREAD_MUTEX_CONTENDED) linux_thread_futex_wake(word, 1);
+    }
+
+    //-------------------------------------------------------------------
+    // CONDITION
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_FUNC bool
+    linux_thread_condition_create(
+        os_thread_condition& condition) {
+
+        condition.os_handle = NULL;
+        new (&condition.os_handle) std::atomic<u32>(0);
+        return(true);
+    }
+
+    SLD_API_OS_FUNC bool
+    linux_thread_condition_destroy(
+        os_thread_condition& condition) {
+
+        condition.os_handle = NULL;
+        return(true);
+    }
+
+    SLD_API_OS_FUNC void
+    linux_thread_condition_wait(
+        os_thread_condition& condition,
+        os_thread_mutex&     mutex) {
+
+        // the sequence is read before unlocking, a signal after that changes it and
+        // the futex wait returns straight away instead of missing it.
+        // wakeups can be spurious, callers check their predicate in a loop
+        std::atomic<u32>* sequence       = linux_thread_futex_word(condition.os_handle);
+        const u32         sequence_value = sequence->load(std::memory_order_relaxed);
+
+        linux_thread_mutex_unlock(mutex);
+        linux_thread_futex_wait(sequence, sequence_value);
+        linux_thread_mutex_lock(mutex);
+    }
+
+    SLD_API_OS_FUNC void
+    linux_thread_condition_signal(
+        os_thread_condition& condition) {
+
+        std::atomic<u32>* sequence = linux_thread_futex_word(condition.os_handle);
+        sequence->fetch_add(1, std::memory_order_release);
+        linux_thread_futex_wake(sequence, 1);
+    }
+
+    SLD_API_OS_FUNC void
+    linux_thread_condition_broadcast(
+        os_thread_condition& condition) {
+
+        std::atomic<u32>* sequence = linux_thread_futex_word(condition.os_handle);
+        sequence->fetch_add(1, std::memory_order_release);
+        linux_thread_futex_wake(sequence, INT_MAX);
+    }
+};
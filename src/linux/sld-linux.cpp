@@ -0,0 +1,9 @@
+#pragma once
+
+#include "sld-os.hpp"
+
+#include "sld-linux-memory.cpp"
+#include "sld-linux-file.cpp"
+#include "sld-linux-thread.cpp"
+#include "sld-linux-fiber.cpp"
+#include "sld-linux-system.cpp"
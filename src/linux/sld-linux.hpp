@@ -0,0 +1,97 @@
+#ifndef SLD_LINUX_HPP
+#define SLD_LINUX_HPP
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <atomic>
+#include <sld-os.hpp>
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // GLOBALS
+    //-------------------------------------------------------------------
+
+    SLD_GLOBAL os_file_error _last_error_file;
+
+    //-------------------------------------------------------------------
+    // METHODS
+    //-------------------------------------------------------------------
+
+    // memory
+    SLD_API_OS_INTERNAL const u64         linux_memory_get_page_size  (void);
+
+    // file
+    SLD_API_OS_INTERNAL s32               linux_file_get_fd           (const os_file_handle file_hnd);
+    SLD_API_OS_INTERNAL os_file_handle    linux_file_handle_from_fd   (const s32 fd);
+    SLD_API_OS_INTERNAL void              linux_file_set_last_error   (void);
+    SLD_API_OS_INTERNAL void              linux_file_clear_last_error (void);
+    SLD_API_OS_INTERNAL bool              linux_file_map_view_prot    (const os_file_map_handle map_hnd, const u64 offset, const u64 size, const s32 prot, os_file_mapped_buffer* view);
+
+    // thread
+    SLD_API_OS_INTERNAL std::atomic<u32>* linux_thread_futex_word     (vptr& os_handle);
+    SLD_API_OS_INTERNAL void              linux_thread_futex_wait     (std::atomic<u32>* word, const u32 value);
+    SLD_API_OS_INTERNAL void              linux_thread_futex_wake     (std::atomic<u32>* word, const s32 count);
+
+    // system
+    SLD_API_OS_INTERNAL u32               linux_system_count_cpu_list (const cchar* list);
+};
+
+#define linux_system_get_cpu_info         os_system_get_cpu_info
+#define linux_system_time_ms              os_system_time_ms
+#define linux_system_sleep                os_system_sleep
+
+#define linux_file_get_last_error         os_file_get_last_error
+#define linux_file_open                   os_file_open
+#define linux_file_close                  os_file_close
+#define linux_file_get_size               os_file_get_size
+#define linux_file_map_get_granularity    os_file_map_get_granularity
+#define linux_file_map_create             os_file_map_create
+#define linux_file_map_create_writable    os_file_map_create_writable
+#define linux_file_map_destroy            os_file_map_destroy
+#define linux_file_map_view               os_file_map_view
+#define linux_file_map_view_writable      os_file_map_view_writable
+#define linux_file_map_unview             os_file_map_unview
+#define linux_file_map_prefetch           os_file_map_prefetch
+#define linux_file_map_flush              os_file_map_flush
+
+#define linux_memory_alloc                os_memory_alloc
+#define linux_memory_free                 os_memory_free
+#define linux_memory_reserve              os_memory_reserve
+#define linux_memory_reserve_large        os_memory_reserve_large
+#define linux_memory_release              os_memory_release
+#define linux_memory_commit               os_memory_commit
+#define linux_memory_decommit             os_memory_decommit
+#define linux_memory_align_to_page        os_memory_align_to_page
+#define linux_memory_align_to_granularity os_memory_align_to_granularity
+#define linux_memory_align_to_large_page  os_memory_align_to_large_page
+#define linux_memory_get_large_page_size  os_memory_get_large_page_size
+#define linux_memory_is_reserved          os_memory_is_reserved
+#define linux_memory_is_committed         os_memory_is_committed
+
+#define linux_thread_create               os_thread_create
+#define linux_thread_join                 os_thread_join
+#define linux_thread_get_current          os_thread_get_current
+#define linux_thread_set_name             os_thread_set_name
+#define linux_thread_set_affinity         os_thread_set_affinity
+#define linux_thread_yield                os_thread_yield
+#define linux_thread_sleep                os_thread_sleep
+#define linux_thread_mutex_create         os_thread_mutex_create
+#define linux_thread_mutex_destroy        os_thread_mutex_destroy
+#define linux_thread_mutex_lock           os_thread_mutex_lock
+#define linux_thread_mutex_try_lock       os_thread_mutex_try_lock
+#define linux_thread_mutex_unlock         os_thread_mutex_unlock
+#define linux_thread_condition_create     os_thread_condition_create
+#define linux_thread_condition_destroy    os_thread_condition_destroy
+#define linux_thread_condition_wait       os_thread_condition_wait
+#define linux_thread_condition_signal     os_thread_condition_signal
+#define linux_thread_condition_broadcast  os_thread_condition_broadcast
+
+#define linux_fiber_create                os_fiber_create
+#define linux_fiber_destroy               os_fiber_destroy
+#define linux_fiber_from_thread           os_fiber_from_thread
+#define linux_fiber_to_thread             os_fiber_to_thread
+#define linux_fiber_switch                os_fiber_switch
+
+#endif //SLD_LINUX_HPP
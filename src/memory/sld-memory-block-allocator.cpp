@@ -0,0 +1,452 @@
+#pragma once
+
+#include "sld-block-allocator.hpp"
+
+namespace sld {
+
+    SLD_API bool
+    block_allocator_validate(
+        const block_allocator_t* allocator) {
+
+        bool is_valid = (allocator != NULL);
+        if (is_valid) {
+            is_valid &= (allocator->start             != 0);
+            is_valid &= (allocator->size_reserved     != 0);
+            is_valid &= (allocator->blocks            >  allocator->start);
+            is_valid &= (allocator->block_size        != 0);
+            is_valid &= (allocator->block_count       != 0);
+            is_valid &= (allocator->block_count_fresh <= allocator->block_count);
+            is_valid &= (allocator->free_count        <= allocator->block_count_fresh);
+            is_valid &= (allocator->free_stack        != NULL);
+        }
+        return(is_valid);
+    }
+
+    struct block_allocator_reservation_t {
+        void* memory;
+        u64   size_reserved;
+        u64   size_header;
+        u64   block_size;
+        u64   block_count;
+        bool  is_large_pages;
+    };
+
+    SLD_INTERNAL bool
+    block_allocator_reserve_blocks(
+        const u64                      size_total,
+        const u32                      size_block,
+        const u32                      size_index,
+        const bool                     use_large_pages,
+        block_allocator_reservation_t& reservation) {
+
+        bool can_reserve = true;
+        can_reserve &= (size_total != 0);
+        can_reserve &= (size_block != 0);
+        can_reserve &= (size_block <= size_total);
+        if (!can_reserve) return(false);
+
+        // NOTE(SAM): a large page only helps if it's fully inside a block,
+        // so with large pages the block size is rounded up to one
+        const u64 block_size = use_large_pages
+            ? os_memory_align_to_large_page (size_block)
+            : os_memory_align_to_page       (size_block);
+        const u64 block_count = (size_total + block_size - 1) / block_size;
+        if (block_count >= BLOCK_ALLOCATOR_INVALID_INDEX || block_size > 0xFFFFFFFF) return(false);
+
+        // the free list indices live in front of the blocks
+        const u64 size_header = use_large_pages
+            ? os_memory_align_to_large_page  (block_count * size_index)
+            : os_memory_align_to_granularity (block_count * size_index);
+        const u64 size_reserved = size_header + (block_count * block_size);
+
+        // try large pages first and fall back to regular pages
+        void* memory         = NULL;
+        bool  is_large_pages = false;
+        if (use_large_pages) {
+            memory         = os_memory_reserve_large(NULL, size_reserved);
+            is_large_pages = (memory != NULL);
+        }
+        if (!memory) {
+            memory = os_memory_reserve(NULL, size_reserved);
+        }
+        if (!memory) return(false);
+
+        // commit the free list
+        const u64  size_header_commit = os_memory_align_to_page(block_count * size_index);
+        const bool is_committed       = (os_memory_commit(memory, size_header_commit) != NULL);
+        if (!is_committed) {
+            (void)os_memory_release(memory, size_reserved);
+            return(false);
+        }
+
+        reservation.memory         = memory;
+        reservation.size_reserved  = size_reserved;
+        reservation.size_header    = size_header;
+        reservation.block_size     = block_size;
+        reservation.block_count    = block_count;
+        reservation.is_large_pages = is_large_pages;
+        return(true);
+    }
+
+    SLD_API bool
+    block_allocator_reserve_os_memory(
+        block_allocator_t* allocator,
+        const u64          size_total,
+        const u32          size_block,
+        const bool         use_large_pages) {
+
+        if (!allocator) return(false);
+
+        block_allocator_reservation_t reservation;
+        const bool is_reserved = block_allocator_reserve_blocks(
+            size_total,
+            size_block,
+            sizeof(u32),
+            use_large_pages,
+            reservation
+        );
+        if (!is_reserved) return(false);
+
+        allocator->start             = (addr)reservation.memory;
+        allocator->size_reserved     = reservation.size_reserved;
+        allocator->blocks            = (addr)reservation.memory + reservation.size_header;
+        allocator->block_size        = (u32)reservation.block_size;
+        allocator->block_count       = (u32)reservation.block_count;
+        allocator->block_count_fresh = 0;
+        allocator->free_count        = 0;
+        allocator->free_stack        = (u32*)reservation.memory;
+        allocator->flags             = reservation.is_large_pages
+            ? block_allocator_flag_e_large_pages
+            : block_allocator_flag_e_none;
+    #if SLD_ALLOC_TRACKING
+        allocator->tracker           = NULL;
+    #endif
+
+        return(true);
+    }
+
+    SLD_API bool
+    block_allocator_release_os_memory(
+        block_allocator_t* allocator) {
+
+        const bool is_valid = block_allocator_validate(allocator);
+        if (!is_valid) return(is_valid);
+
+        const bool is_released = os_memory_release(
+            (void*)allocator->start,
+            allocator->size_reserved
+        );
+
+        if (is_released) {
+            memset(allocator, 0, sizeof(block_allocator_t));
+        }
+        return(is_released);
+    }
+
+    SLD_API void*
+    block_allocator_commit(
+        block_allocator_t* allocator
+        SLD_ALLOC_SITE_ARGS) {
+
+        const bool is_valid = block_allocator_validate(allocator);
+        if (!is_valid) return(NULL);
+
+        // reuse a decommitted block before touching a fresh one
+        u32 index = BLOCK_ALLOCATOR_INVALID_INDEX;
+        if (allocator->free_count > 0) {
+            --allocator->free_count;
+            index = allocator->free_stack[allocator->free_count];
+        }
+        else if (allocator->block_count_fresh < allocator->block_count) {
+            index = allocator->block_count_fresh;
+            ++allocator->block_count_fresh;
+        }
+
+        void* block = NULL;
+        if (index != BLOCK_ALLOCATOR_INVALID_INDEX) {
+
+            void* block_start = (void*)(allocator->blocks + ((u64)index * allocator->block_size));
+            block = os_memory_commit(block_start, allocator->block_size);
+            if (!block) {
+                allocator->free_stack[allocator->free_count] = index;
+                ++allocator->free_count;
+            }
+        }
+
+    #if SLD_ALLOC_TRACKING
+        if (allocator->tracker) {
+            const u64 blocks_used = (allocator->block_count_fresh - allocator->free_count);
+            const u64 position    = (blocks_used * allocator->block_size);
+            alloc_tracker_record_push(allocator->tracker, allocator->block_size, position, (block != NULL), site_file, site_line);
+        }
+    #endif
+        return(block);
+    }
+
+    SLD_API memory_t
+    block_allocator_commit_memory(
+        block_allocator_t* allocator
+        SLD_ALLOC_SITE_ARGS) {
+
+        memory_t memory;
+        memory.ptr  = block_allocator_commit(allocator SLD_ALLOC_SITE_FORWARD);
+        memory.size = (memory.ptr != NULL) ? allocator->block_size : 0;
+        return(memory);
+    }
+
+    SLD_API bool
+    block_allocator_decommit(
+        block_allocator_t* allocator,
+        void*              block) {
+
+        const u32  index    = block_allocator_get_block_index(allocator, block);
+        const bool is_valid = (index != BLOCK_ALLOCATOR_INVALID_INDEX);
+        if (!is_valid) return(is_valid);
+
+        // NOTE(SAM): large pages on windows can't be decommitted, the block
+        // just stays committed and the next commit of it is a no-op
+        (void)os_memory_decommit(block, allocator->block_size);
+
+        allocator->free_stack[allocator->free_count] = index;
+        ++allocator->free_count;
+        return(is_valid);
+    }
+
+    SLD_API u32
+    block_allocator_get_block_index(
+        const block_allocator_t* allocator,
+        const void*              block) {
+
+        const bool is_valid = block_allocator_validate(allocator) && (block != NULL);
+        if (!is_valid) return(BLOCK_ALLOCATOR_INVALID_INDEX);
+
+        const addr block_addr   = (addr)block;
+        const addr blocks_end   = allocator->blocks + ((u64)allocator->block_count * allocator->block_size);
+        const u64  block_offset = (u64)(block_addr - allocator->blocks);
+
+        const bool is_block = (
+            block_addr >= allocator->blocks &&
+            block_addr <  blocks_end        &&
+            (block_offset % allocator->block_size) == 0
+        );
+
+        const u32 index = is_block
+            ? (u32)(block_offset / allocator->block_size)
+            : BLOCK_ALLOCATOR_INVALID_INDEX;
+        return(index);
+    }
+
+    //-------------------------------------------------------------------
+    // ATOMIC
+    //-------------------------------------------------------------------
+
+    constexpr u64 BLOCK_ALLOCATOR_ATOMIC_INDEX_MASK = 0x00000000FFFFFFFF;
+    constexpr u64 BLOCK_ALLOCATOR_ATOMIC_TAG_ONE    = 0x0000000100000000;
+    constexpr u64 BLOCK_ALLOCATOR_ATOMIC_EMPTY      = BLOCK_ALLOCATOR_INVALID_INDEX;
+
+    SLD_API bool
+    block_allocator_atomic_validate(
+        const block_allocator_atomic_t* allocator) {
+
+        bool is_valid = (allocator != NULL);
+        if (is_valid) {
+            is_valid &= (allocator->start         != 0);
+            is_valid &= (allocator->size_reserved != 0);
+            is_valid &= (allocator->blocks        >  allocator->start);
+            is_valid &= (allocator->block_size    != 0);
+            is_valid &= (allocator->block_count   != 0);
+            is_valid &= (allocator->free_next     != NULL);
+        }
+        return(is_valid);
+    }
+
+    SLD_API bool
+    block_allocator_atomic_reserve_os_memory(
+        block_allocator_atomic_t* allocator,
+        const u64                 size_total,
+        const u32                 size_block,
+        const bool                use_large_pages) {
+
+        if (!allocator) return(false);
+
+        block_allocator_reservation_t reservation;
+        const bool is_reserved = block_allocator_reserve_blocks(
+            size_total,
+            size_block,
+            sizeof(std::atomic<u32>),
+            use_large_pages,
+            reservation
+        );
+        if (!is_reserved) return(false);
+
+        // the next links are zeroed pages, they only need their atomics constructed
+        std::atomic<u32>* free_next = (std::atomic<u32>*)reservation.memory;
+        for (
+            u64 index = 0;
+            index < reservation.block_count;
+            ++index) {
+
+            new (&free_next[index]) std::atomic<u32>(BLOCK_ALLOCATOR_INVALID_INDEX);
+        }
+
+        allocator->start         = (addr)reservation.memory;
+        allocator->size_reserved = reservation.size_reserved;
+        allocator->blocks        = (addr)reservation.memory + reservation.size_header;
+        allocator->block_size    = (u32)reservation.block_size;
+        allocator->block_count   = (u32)reservation.block_count;
+        allocator->free_next     = free_next;
+        allocator->flags         = reservation.is_large_pages
+            ? block_allocator_flag_e_large_pages
+            : block_allocator_flag_e_none;
+        allocator->block_count_fresh.store (0,                            std::memory_order_relaxed);
+        allocator->free_head.store         (BLOCK_ALLOCATOR_ATOMIC_EMPTY, std::memory_order_release);
+
+        return(true);
+    }
+
+    SLD_API bool
+    block_allocator_atomic_release_os_memory(
+        block_allocator_atomic_t* allocator) {
+
+        // NOTE(SAM): not thread safe, nothing else can be using the allocator
+        const bool is_valid = block_allocator_atomic_validate(allocator);
+        if (!is_valid) return(is_valid);
+
+        const bool is_released = os_memory_release(
+            (void*)allocator->start,
+            allocator->size_reserved
+        );
+
+        if (is_released) {
+            allocator->start         = 0;
+            allocator->size_reserved = 0;
+            allocator->blocks        = 0;
+            allocator->block_size    = 0;
+            allocator->block_count   = 0;
+            allocator->free_next     = NULL;
+            allocator->flags         = block_allocator_flag_e_none;
+            allocator->block_count_fresh.store (0,                            std::memory_order_relaxed);
+            allocator->free_head.store         (BLOCK_ALLOCATOR_ATOMIC_EMPTY, std::memory_order_relaxed);
+        }
+        return(is_released);
+    }
+
+    SLD_API void*
+    block_allocator_atomic_commit(
+        block_allocator_atomic_t* allocator) {
+
+        const bool is_valid = block_allocator_atomic_validate(allocator);
+        if (!is_valid) return(NULL);
+
+        // pop a decommitted block, the tag makes the swap fail if the
+        // head was popped and pushed back while we were reading its next link
+        u32 index = BLOCK_ALLOCATOR_INVALID_INDEX;
+        u64 head  = allocator->free_head.load(std::memory_order_acquire);
+        while ((head & BLOCK_ALLOCATOR_ATOMIC_INDEX_MASK) != BLOCK_ALLOCATOR_INVALID_INDEX) {
+
+            const u32 head_index = (u32)(head & BLOCK_ALLOCATOR_ATOMIC_INDEX_MASK);
+            const u32 next_index = allocator->free_next[head_index].load(std::memory_order_relaxed);
+            const u64 head_new   = ((head & ~BLOCK_ALLOCATOR_ATOMIC_INDEX_MASK) + BLOCK_ALLOCATOR_ATOMIC_TAG_ONE) | next_index;
+
+            const bool did_pop = allocator->free_head.compare_exchange_weak(
+                head,
+                head_new,
+                std::memory_order_acquire,
+                std::memory_order_acquire
+            );
+            if (did_pop) {
+                index = head_index;
+                break;
+            }
+        }
+
+        // otherwise take a block that's never been used
+        if (index == BLOCK_ALLOCATOR_INVALID_INDEX) {
+
+            u32 fresh = allocator->block_count_fresh.load(std::memory_order_relaxed);
+            while (fresh < allocator->block_count) {
+
+                const bool did_take = allocator->block_count_fresh.compare_exchange_weak(
+                    fresh,
+                    fresh + 1,
+                    std::memory_order_relaxed
+                );
+                if (did_take) {
+                    index = fresh;
+                    break;
+                }
+            }
+        }
+        if (index == BLOCK_ALLOCATOR_INVALID_INDEX) return(NULL);
+
+        void* block_start = (void*)(allocator->blocks + ((u64)index * allocator->block_size));
+        void* block       = os_memory_commit(block_start, allocator->block_size);
+        if (!block) {
+            (void)block_allocator_atomic_decommit(allocator, block_start);
+        }
+        return(block);
+    }
+
+    SLD_API memory_t
+    block_allocator_atomic_commit_memory(
+        block_allocator_atomic_t* allocator) {
+
+        memory_t memory;
+        memory.ptr  = block_allocator_atomic_commit(allocator);
+        memory.size = (memory.ptr != NULL) ? allocator->block_size : 0;
+        return(memory);
+    }
+
+    SLD_API bool
+    block_allocator_atomic_decommit(
+        block_allocator_atomic_t* allocator,
+        void*                     block) {
+
+        const u32  index    = block_allocator_atomic_get_block_index(allocator, block);
+        const bool is_valid = (index != BLOCK_ALLOCATOR_INVALID_INDEX);
+        if (!is_valid) return(is_valid);
+
+        // decommit before the block is visible to other threads again
+        (void)os_memory_decommit(block, allocator->block_size);
+
+        u64 head = allocator->free_head.load(std::memory_order_relaxed);
+        bool did_push = false;
+        while (!did_push) {
+
+            allocator->free_next[index].store((u32)(head & BLOCK_ALLOCATOR_ATOMIC_INDEX_MASK), std::memory_order_relaxed);
+
+            const u64 head_new = ((head & ~BLOCK_ALLOCATOR_ATOMIC_INDEX_MASK) + BLOCK_ALLOCATOR_ATOMIC_TAG_ONE) | index;
+            did_push = allocator->free_head.compare_exchange_weak(
+                head,
+                head_new,
+                std::memory_order_release,
+                std::memory_order_relaxed
+            );
+        }
+        return(is_valid);
+    }
+
+    SLD_API u32
+    block_allocator_atomic_get_block_index(
+        const block_allocator_atomic_t* allocator,
+        const void*                     block) {
+
+        const bool is_valid = block_allocator_atomic_validate(allocator) && (block != NULL);
+        if (!is_valid) return(BLOCK_ALLOCATOR_INVALID_INDEX);
+
+        const addr block_addr   = (addr)block;
+        const addr blocks_end   = allocator->blocks + ((u64)allocator->block_count * allocator->block_size);
+        const u64  block_offset = (u64)(block_addr - allocator->blocks);
+
+        const bool is_block = (
+            block_addr >= allocator->blocks &&
+            block_addr <  blocks_end        &&
+            (block_offset % allocator->block_size) == 0
+        );
+
+        const u32 index = is_block
+            ? (u32)(block_offset / allocator->block_size)
+            : BLOCK_ALLOCATOR_INVALID_INDEX;
+        return(index);
+    }
+};
\ No newline at end of file
@@ -0,0 +1,428 @@
+#pragma once
+
+#include "sld-heap.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // CONSTANTS
+    //-------------------------------------------------------------------
+
+    constexpr u64 HEAP_NODE_FLAG_FREE      = bit_value(0);
+    constexpr u64 HEAP_NODE_FLAG_PREV_FREE = bit_value(1);
+    constexpr u64 HEAP_NODE_FLAG_MASK      = (HEAP_NODE_FLAG_FREE | HEAP_NODE_FLAG_PREV_FREE);
+
+    // NOTE(SAM): a used node only pays for its size, the previous physical
+    // pointer lives in the tail of the node before it and is only written when that node is free
+    constexpr u64 HEAP_NODE_OVERHEAD       = sizeof(u64);
+    constexpr u64 HEAP_NODE_DATA_OFFSET    = sizeof(heap_node_t*) + sizeof(u64);
+    constexpr u64 HEAP_NODE_SIZE_MIN       = sizeof(heap_node_t) - sizeof(heap_node_t*);
+    constexpr u64 HEAP_NODE_SIZE_MAX       = ((u64)1 << HEAP_FL_INDEX_MAX);
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_INTERNAL void         heap_node_remove_free   (heap_t* heap, heap_node_t* node, const u32 fl, const u32 sl);
+    SLD_INTERNAL void         heap_node_insert_free   (heap_t* heap, heap_node_t* node, const u32 fl, const u32 sl);
+    SLD_INTERNAL void         heap_node_remove        (heap_t* heap, heap_node_t* node);
+    SLD_INTERNAL void         heap_node_insert        (heap_t* heap, heap_node_t* node);
+    SLD_INTERNAL heap_node_t* heap_node_merge_prev    (heap_t* heap, heap_node_t* node);
+    SLD_INTERNAL heap_node_t* heap_node_merge_next    (heap_t* heap, heap_node_t* node);
+    SLD_INTERNAL void         heap_node_trim_free     (heap_t* heap, heap_node_t* node, const u64 size);
+    SLD_INTERNAL heap_node_t* heap_node_locate_free   (heap_t* heap, const u64 size);
+    SLD_INTERNAL void         heap_mapping_insert     (const u64 size, u32& fl, u32& sl);
+    SLD_INTERNAL void         heap_mapping_search     (const u64 size, u32& fl, u32& sl);
+
+    SLD_INLINE u64          heap_node_size          (const heap_node_t* node)                 { return(node->size & ~HEAP_NODE_FLAG_MASK);                                }
+    SLD_INLINE void         heap_node_set_size      (heap_node_t*       node, const u64 size) { node->size = size | (node->size & HEAP_NODE_FLAG_MASK);                   }
+    SLD_INLINE bool         heap_node_is_last       (const heap_node_t* node)                 { return(heap_node_size(node) == 0);                                        }
+    SLD_INLINE bool         heap_node_is_free       (const heap_node_t* node)                 { return((node->size & HEAP_NODE_FLAG_FREE) != 0);                          }
+    SLD_INLINE void         heap_node_set_free      (heap_node_t*       node)                 { node->size |=  HEAP_NODE_FLAG_FREE;                                       }
+    SLD_INLINE void         heap_node_set_used      (heap_node_t*       node)                 { node->size &= ~HEAP_NODE_FLAG_FREE;                                       }
+    SLD_INLINE bool         heap_node_is_prev_free  (const heap_node_t* node)                 { return((node->size & HEAP_NODE_FLAG_PREV_FREE) != 0);                     }
+    SLD_INLINE void         heap_node_set_prev_free (heap_node_t*       node)                 { node->size |=  HEAP_NODE_FLAG_PREV_FREE;                                  }
+    SLD_INLINE void         heap_node_set_prev_used (heap_node_t*       node)                 { node->size &= ~HEAP_NODE_FLAG_PREV_FREE;                                  }
+    SLD_INLINE heap_node_t* heap_node_next          (const heap_node_t* node)                 { return((heap_node_t*)(heap_node_get_data(node) + heap_node_size(node) - HEAP_NODE_OVERHEAD)); }
+
+    SLD_INLINE heap_node_t*
+    heap_node_link_next(
+        heap_node_t* node) {
+
+        heap_node_t* next = heap_node_next(node);
+        next->prev_physical = node;
+        return(next);
+    }
+
+    SLD_INLINE void
+    heap_node_mark_as_free(
+        heap_node_t* node) {
+
+        heap_node_t* next = heap_node_link_next(node);
+        heap_node_set_prev_free (next);
+        heap_node_set_free      (node);
+    }
+
+    SLD_INLINE void
+    heap_node_mark_as_used(
+        heap_node_t* node) {
+
+        heap_node_t* next = heap_node_next(node);
+        heap_node_set_prev_used (next);
+        heap_node_set_used      (node);
+    }
+
+    SLD_INTERNAL void
+    heap_mapping_insert(
+        const u64 size,
+        u32&      fl,
+        u32&      sl) {
+
+        // small sizes share the first list, split linearly
+        if (size < HEAP_SMALL_BLOCK_SIZE) {
+            fl = 0;
+            sl = (u32)(size / (HEAP_SMALL_BLOCK_SIZE / HEAP_SL_COUNT));
+            return;
+        }
+
+        const u32 fl_bit = bit_scan_reverse_64(size);
+        sl = (u32)(size >> (fl_bit - HEAP_SL_COUNT_LOG2)) ^ HEAP_SL_COUNT;
+        fl = fl_bit - (HEAP_FL_INDEX_SHIFT - 1);
+    }
+
+    SLD_INTERNAL void
+    heap_mapping_search(
+        const u64 size,
+        u32&      fl,
+        u32&      sl) {
+
+        // round up to the next list so any node in it is big enough
+        u64 size_rounded = size;
+        if (size >= HEAP_SMALL_BLOCK_SIZE) {
+            const u64 round = ((u64)1 << (bit_scan_reverse_64(size) - HEAP_SL_COUNT_LOG2)) - 1;
+            size_rounded += round;
+        }
+        heap_mapping_insert(size_rounded, fl, sl);
+    }
+
+    SLD_INTERNAL void
+    heap_node_remove_free(
+        heap_t*      heap,
+        heap_node_t* node,
+        const u32    fl,
+        const u32    sl) {
+
+        heap_node_t* prev = node->prev_free;
+        heap_node_t* next = node->next_free;
+        next->prev_free = prev;
+        prev->next_free = next;
+
+        // if this was the head, clear the bitmaps when the list runs out
+        if (heap->free_lists[fl][sl] == node) {
+            heap->free_lists[fl][sl] = next;
+            if (next == &heap->null_node) {
+                heap->sl_bitmap[fl] &= ~bit_value(sl);
+                if (heap->sl_bitmap[fl] == 0) {
+                    heap->fl_bitmap &= ~bit_value(fl);
+                }
+            }
+        }
+    }
+
+    SLD_INTERNAL void
+    heap_node_insert_free(
+        heap_t*      heap,
+        heap_node_t* node,
+        const u32    fl,
+        const u32    sl) {
+
+        heap_node_t* current = heap->free_lists[fl][sl];
+        node->next_free    = current;
+        node->prev_free    = &heap->null_node;
+        current->prev_free = node;
+
+        heap->free_lists[fl][sl] = node;
+        heap->fl_bitmap     |= bit_value(fl);
+        heap->sl_bitmap[fl] |= bit_value(sl);
+    }
+
+    SLD_INTERNAL void
+    heap_node_remove(
+        heap_t*      heap,
+        heap_node_t* node) {
+
+        u32 fl, sl;
+        heap_mapping_insert   (heap_node_size(node), fl, sl);
+        heap_node_remove_free (heap, node, fl, sl);
+    }
+
+    SLD_INTERNAL void
+    heap_node_insert(
+        heap_t*      heap,
+        heap_node_t* node) {
+
+        u32 fl, sl;
+        heap_mapping_insert   (heap_node_size(node), fl, sl);
+        heap_node_insert_free (heap, node, fl, sl);
+    }
+
+    SLD_INTERNAL heap_node_t*
+    heap_node_merge_prev(
+        heap_t*      heap,
+        heap_node_t* node) {
+
+        if (!heap_node_is_prev_free(node)) return(node);
+
+        heap_node_t* prev = node->prev_physical;
+        assert(prev != NULL && heap_node_is_free(prev));
+
+        heap_node_remove   (heap, prev);
+        heap_node_set_size (prev, heap_node_size(prev) + heap_node_size(node) + HEAP_NODE_OVERHEAD);
+        heap_node_link_next(prev);
+        return(prev);
+    }
+
+    SLD_INTERNAL heap_node_t*
+    heap_node_merge_next(
+        heap_t*      heap,
+        heap_node_t* node) {
+
+        heap_node_t* next = heap_node_next(node);
+        if (!heap_node_is_free(next)) return(node);
+
+        assert(!heap_node_is_last(next));
+
+        heap_node_remove   (heap, next);
+        heap_node_set_size (node, heap_node_size(node) + heap_node_size(next) + HEAP_NODE_OVERHEAD);
+        heap_node_link_next(node);
+        return(node);
+    }
+
+    SLD_INTERNAL void
+    heap_node_trim_free(
+        heap_t*      heap,
+        heap_node_t* node,
+        const u64    size) {
+
+        // only split if the remainder can hold a node of its own
+        const bool can_split = (heap_node_size(node) >= (sizeof(heap_node_t) + size));
+        if (!can_split) return;
+
+        heap_node_t* remaining      = (heap_node_t*)(heap_node_get_data(node) + size - HEAP_NODE_OVERHEAD);
+        const u64    remaining_size = heap_node_size(node) - (size + HEAP_NODE_OVERHEAD);
+
+        remaining->size = 0;
+        heap_node_set_size     (remaining, remaining_size);
+        heap_node_set_size     (node,      size);
+        heap_node_mark_as_free (remaining);
+
+        heap_node_link_next     (node);
+        heap_node_set_prev_free (remaining);
+        heap_node_insert        (heap, remaining);
+    }
+
+    SLD_INTERNAL heap_node_t*
+    heap_node_locate_free(
+        heap_t*   heap,
+        const u64 size) {
+
+        u32 fl = 0;
+        u32 sl = 0;
+        heap_mapping_search(size, fl, sl);
+        if (fl >= HEAP_FL_COUNT) return(NULL);
+
+        // look for a list in this first level at or above the second level,
+        // otherwise take the smallest non-empty first level above it
+        u32 sl_map = heap->sl_bitmap[fl] & (~0u << sl);
+        if (sl_map == 0) {
+
+            const u32 fl_map = (fl + 1 < 32) ? (heap->fl_bitmap & (~0u << (fl + 1))) : 0;
+            if (fl_map == 0) return(NULL);
+
+            fl     = bit_scan_forward(fl_map);
+            sl_map = heap->sl_bitmap[fl];
+        }
+        sl = bit_scan_forward(sl_map);
+
+        heap_node_t* node = heap->free_lists[fl][sl];
+        assert(node != &heap->null_node && heap_node_size(node) >= size);
+
+        heap_node_remove_free(heap, node, fl, sl);
+        return(node);
+    }
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    SLD_API const u64
+    heap_memory_size(
+        const u64 heap_size_min) {
+
+        // header, the first node and the sentinel at the end of the pool
+        const u64 size_header = size_align_pow_2(sizeof(heap_t), HEAP_ALIGN_SIZE);
+        const u64 size_pool   = size_align_pow_2(heap_size_min,  HEAP_ALIGN_SIZE);
+        const u64 size_total  = size_header + HEAP_NODE_DATA_OFFSET + size_pool + HEAP_NODE_OVERHEAD;
+        return(size_total);
+    }
+
+    SLD_API bool
+    heap_validate(
+        const heap_t* heap) {
+
+        bool is_valid = (heap != NULL);
+        if (is_valid) {
+            is_valid &= memory_is_valid(heap->memory);
+            is_valid &= (heap->memory.ptr   == (void*)heap);
+            is_valid &= (heap->granularity  >= HEAP_ALIGN_SIZE);
+            is_valid &= size_is_pow_2(heap->granularity);
+            is_valid &= (heap->size_pool    >= HEAP_NODE_SIZE_MIN);
+            is_valid &= (heap->size_pool    <  HEAP_NODE_SIZE_MAX);
+        }
+        return(is_valid);
+    }
+
+    SLD_API heap_t*
+    heap_init(
+        const memory_t& memory,
+        const u64       granularity) {
+
+        bool can_init = true;
+        can_init &= memory_is_valid(memory);
+        can_init &= (memory.size  >= heap_memory_size(HEAP_NODE_SIZE_MIN));
+        can_init &= ((memory.start & (HEAP_ALIGN_SIZE - 1)) == 0);
+        if (!can_init) return(NULL);
+
+        // NOTE(SAM): the free flags live in the low bits of the size, so nothing
+        // smaller than the heap alignment works as a granularity
+        const u64 granularity_pow_2 = size_round_up_pow2(granularity);
+
+        heap_t* heap = (heap_t*)memory.ptr;
+        heap->memory      = memory;
+        heap->granularity = (granularity_pow_2 > HEAP_ALIGN_SIZE) ? granularity_pow_2 : HEAP_ALIGN_SIZE;
+
+        // the pool is whatever is left after the header and the sentinel
+        const u64 size_header = size_align_pow_2(sizeof(heap_t), HEAP_ALIGN_SIZE);
+        const u64 size_pool   = (memory.size - size_header - HEAP_NODE_DATA_OFFSET - HEAP_NODE_OVERHEAD) & ~(HEAP_ALIGN_SIZE - 1);
+        heap->size_pool = (size_pool < HEAP_NODE_SIZE_MAX) ? size_pool : (HEAP_NODE_SIZE_MAX - HEAP_ALIGN_SIZE);
+
+        (void)heap_reset(heap);
+        return(heap);
+    }
+
+    SLD_API bool
+    heap_reset(
+        heap_t* heap) {
+
+        const bool is_valid = heap_validate(heap);
+        if (!is_valid) return(is_valid);
+
+        // NOTE(SAM): the null node terminates every free list, its links get
+        // written by removals but nothing ever reads them
+        heap->null_node.prev_physical = NULL;
+        heap->null_node.size          = 0;
+        heap->null_node.next_free     = &heap->null_node;
+        heap->null_node.prev_free     = &heap->null_node;
+
+        heap->fl_bitmap = 0;
+        for (
+            u32 fl = 0;
+            fl < HEAP_FL_COUNT;
+            ++fl) {
+
+            heap->sl_bitmap[fl] = 0;
+            for (
+                u32 sl = 0;
+                sl < HEAP_SL_COUNT;
+                ++sl) {
+
+                heap->free_lists[fl][sl] = &heap->null_node;
+            }
+        }
+
+        // one free node covering the pool
+        const u64    size_header = size_align_pow_2(sizeof(heap_t), HEAP_ALIGN_SIZE);
+        heap_node_t* node        = (heap_node_t*)(heap->memory.start + size_header);
+        node->prev_physical = NULL;
+        node->size          = heap->size_pool;
+        heap_node_set_free (node);
+        heap_node_insert   (heap, node);
+
+        // the sentinel is an empty used node so merges stop at the end of the pool
+        heap_node_t* last = heap_node_link_next(node);
+        last->size = 0;
+        heap_node_set_used      (last);
+        heap_node_set_prev_free (last);
+
+        return(is_valid);
+    }
+
+    SLD_API heap_node_t*
+    heap_insert(
+        heap_t*   heap,
+        const u32 size) {
+
+        assert(heap_validate(heap));
+        if (size == 0) return(NULL);
+
+        // round to the granularity and make room for the free list links
+        u64 size_adjusted = size_align_pow_2(size, heap->granularity);
+        if (size_adjusted < HEAP_NODE_SIZE_MIN) {
+            size_adjusted = HEAP_NODE_SIZE_MIN;
+        }
+
+        heap_node_t* node = heap_node_locate_free(heap, size_adjusted);
+        if (node) {
+            heap_node_trim_free    (heap, node, size_adjusted);
+            heap_node_mark_as_used (node);
+        }
+        return(node);
+    }
+
+    SLD_API bool
+    heap_remove(
+        heap_t*      heap,
+        heap_node_t* node) {
+
+        const bool can_remove = (
+            heap_validate(heap)                       &&
+            node != NULL                              &&
+            (addr)node > heap->memory.start           &&
+            (addr)node < (heap->memory.start + (addr)heap->memory.size) &&
+            !heap_node_is_free(node)
+        );
+        if (!can_remove) return(can_remove);
+
+        heap_node_mark_as_free(node);
+        node = heap_node_merge_prev (heap, node);
+        node = heap_node_merge_next (heap, node);
+        heap_node_insert(heap, node);
+        return(can_remove);
+    }
+
+    SLD_API byte*
+    heap_node_get_data(
+        const heap_node_t* node) {
+
+        assert(node != NULL);
+        byte* data = ((byte*)node) + HEAP_NODE_DATA_OFFSET;
+        return(data);
+    }
+
+    SLD_API u64
+    heap_node_get_size(
+        const heap_node_t* node) {
+
+        assert(node != NULL);
+        return(heap_node_size(node));
+    }
+
+    SLD_API heap_node_t*
+    heap_node_from_data(
+        const void* data) {
+
+        assert(data != NULL);
+        heap_node_t* node = (heap_node_t*)(((addr)data) - HEAP_NODE_DATA_OFFSET);
+        return(node);
+    }
+};
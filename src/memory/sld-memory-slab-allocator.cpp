@@ -0,0 +1,321 @@
+#pragma once
+
+#include <immintrin.h>
+
+#include "sld-slab-allocator.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_INTERNAL void  slab_class_lock       (slab_class_t*     slab_class);
+    SLD_INTERNAL void  slab_class_unlock     (slab_class_t*     slab_class);
+    SLD_INTERNAL u32   slab_class_pop_batch  (slab_allocator_t* slab, const u32 class_index, void**       objects, const u32 count);
+    SLD_INTERNAL void  slab_class_push_batch (slab_allocator_t* slab, const u32 class_index, void* const* objects, const u32 count);
+    SLD_INTERNAL auto  slab_get_header       (const slab_allocator_t* slab, const void* object) -> slab_header_t*;
+
+    SLD_INTERNAL void
+    slab_class_lock(
+        slab_class_t* slab_class) {
+
+        // the critical sections are a handful of pointer writes, spinning beats sleeping
+        while (slab_class->lock.test_and_set(std::memory_order_acquire)) {
+            _mm_pause();
+        }
+    }
+
+    SLD_INTERNAL void
+    slab_class_unlock(
+        slab_class_t* slab_class) {
+
+        slab_class->lock.clear(std::memory_order_release);
+    }
+
+    SLD_INTERNAL u32
+    slab_class_pop_batch(
+        slab_allocator_t* slab,
+        const u32         class_index,
+        void**            objects,
+        const u32         count) {
+
+        slab_class_t* slab_class = &slab->classes[class_index];
+        u32           popped     = 0;
+
+        slab_class_lock(slab_class);
+
+        while (popped < count) {
+
+            // freed objects first, they're the most likely to be in cache
+            if (slab_class->free_list) {
+                void* object          = slab_class->free_list;
+                slab_class->free_list = *(void**)object;
+                objects[popped]       = object;
+                ++popped;
+                continue;
+            }
+
+            // then carve from the current slab
+            if (slab_class->slab_cursor < slab_class->slab_end) {
+                objects[popped]          = (void*)slab_class->slab_cursor;
+                slab_class->slab_cursor += slab_class->object_size;
+                ++popped;
+                continue;
+            }
+
+            // then start a new slab
+            slab_header_t* header = (slab_header_t*)block_allocator_atomic_commit(&slab->blocks);
+            if (!header) break;
+
+            const u32 object_count = (slab->blocks.block_size - SLAB_HEADER_SIZE) / slab_class->object_size;
+            header->class_index  = class_index;
+            header->object_size  = slab_class->object_size;
+            header->object_count = object_count;
+
+            slab_class->slab_cursor = (addr)header + SLAB_HEADER_SIZE;
+            slab_class->slab_end    = slab_class->slab_cursor + ((u64)object_count * slab_class->object_size);
+            ++slab_class->slab_count;
+        }
+
+        slab_class_unlock(slab_class);
+        return(popped);
+    }
+
+    SLD_INTERNAL void
+    slab_class_push_batch(
+        slab_allocator_t* slab,
+        const u32         class_index,
+        void* const*      objects,
+        const u32         count) {
+
+        if (count == 0) return;
+
+        // link the batch outside the lock, then splice it in
+        for (
+            u32 index = 0;
+            index < (count - 1);
+            ++index) {
+
+            *(void**)objects[index] = objects[index + 1];
+        }
+
+        slab_class_t* slab_class = &slab->classes[class_index];
+        slab_class_lock(slab_class);
+        *(void**)objects[count - 1] = slab_class->free_list;
+        slab_class->free_list       = objects[0];
+        slab_class_unlock(slab_class);
+    }
+
+    SLD_INTERNAL auto
+    slab_get_header(
+        const slab_allocator_t* slab,
+        const void*             object) -> slab_header_t* {
+
+        // every slab is a block, so the header is at the start of the block the object is in
+        const block_allocator_atomic_t& blocks = slab->blocks;
+
+        const addr object_addr = (addr)object;
+        const addr blocks_end  = blocks.blocks + ((u64)blocks.block_count * blocks.block_size);
+        const bool is_in_slab  = (object_addr >= (blocks.blocks + SLAB_HEADER_SIZE) && object_addr < blocks_end);
+        if (!is_in_slab) return(NULL);
+
+        const u64      block_index = (u64)(object_addr - blocks.blocks) / blocks.block_size;
+        slab_header_t* header      = (slab_header_t*)(blocks.blocks + (block_index * blocks.block_size));
+        return(header);
+    }
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    SLD_API bool
+    slab_allocator_validate(
+        const slab_allocator_t* slab) {
+
+        bool is_valid = (slab != NULL);
+        if (is_valid) {
+            is_valid &= block_allocator_atomic_validate(&slab->blocks);
+            is_valid &= (slab->blocks.block_size >= (SLAB_HEADER_SIZE + SLAB_CLASS_SIZE_MAX));
+        }
+        return(is_valid);
+    }
+
+    SLD_API bool
+    slab_allocator_reserve_os_memory(
+        slab_allocator_t* slab,
+        const u64         size_total,
+        const u32         size_block,
+        const bool        use_large_pages) {
+
+        // the largest class has to fit in a slab with its header
+        bool can_reserve = true;
+        can_reserve &= (slab       != NULL);
+        can_reserve &= (size_block >= (SLAB_HEADER_SIZE + SLAB_CLASS_SIZE_MAX));
+        if (!can_reserve) return(false);
+
+        const bool is_reserved = block_allocator_atomic_reserve_os_memory(
+            &slab->blocks,
+            size_total,
+            size_block,
+            use_large_pages
+        );
+        if (!is_reserved) return(false);
+
+        for (
+            u32 class_index = 0;
+            class_index < SLAB_CLASS_COUNT;
+            ++class_index) {
+
+            slab_class_t* slab_class = &slab->classes[class_index];
+            slab_class->lock.clear();
+            slab_class->free_list   = NULL;
+            slab_class->slab_cursor = 0;
+            slab_class->slab_end    = 0;
+            slab_class->object_size = (SLAB_CLASS_SIZE_MIN << class_index);
+            slab_class->slab_count  = 0;
+        }
+
+        return(true);
+    }
+
+    SLD_API bool
+    slab_allocator_release_os_memory(
+        slab_allocator_t* slab) {
+
+        // NOTE(SAM): every magazine has to be flushed or abandoned before this
+        const bool is_valid = slab_allocator_validate(slab);
+        if (!is_valid) return(is_valid);
+
+        const bool is_released = block_allocator_atomic_release_os_memory(&slab->blocks);
+        return(is_released);
+    }
+
+    SLD_API u32
+    slab_allocator_get_class(
+        const u32 size) {
+
+        if (size == 0 || size > SLAB_CLASS_SIZE_MAX) return(SLAB_CLASS_INVALID);
+        if (size <= SLAB_CLASS_SIZE_MIN)             return(0);
+
+        const u32 class_index = bit_scan_reverse(size - 1) + 1 - SLAB_CLASS_SIZE_MIN_LOG2;
+        return(class_index);
+    }
+
+    SLD_API void*
+    slab_allocator_alloc(
+        slab_allocator_t* slab,
+        slab_magazine_t*  magazine,
+        const u32         size) {
+
+        assert(slab_allocator_validate(slab));
+
+        const u32 class_index = slab_allocator_get_class(size);
+        if (class_index == SLAB_CLASS_INVALID) return(NULL);
+
+        void* object = NULL;
+        if (!magazine) {
+            (void)slab_class_pop_batch(slab, class_index, &object, 1);
+            return(object);
+        }
+
+        // refill half the magazine at a time so a thread that allocates
+        // and frees in turn doesn't bounce on the class lock
+        u32& count = magazine->count[class_index];
+        if (count == 0) {
+            count = slab_class_pop_batch(
+                slab,
+                class_index,
+                magazine->objects[class_index],
+                SLAB_MAGAZINE_CAPACITY / 2
+            );
+        }
+        if (count > 0) {
+            --count;
+            object = magazine->objects[class_index][count];
+        }
+        return(object);
+    }
+
+    SLD_API bool
+    slab_allocator_free(
+        slab_allocator_t* slab,
+        slab_magazine_t*  magazine,
+        void*             object) {
+
+        assert(slab_allocator_validate(slab));
+
+        const slab_header_t* header   = slab_get_header(slab, object);
+        const bool           is_valid = (header != NULL && header->class_index < SLAB_CLASS_COUNT);
+        if (!is_valid) return(is_valid);
+
+        const u32 class_index = header->class_index;
+        if (!magazine) {
+            slab_class_push_batch(slab, class_index, &object, 1);
+            return(is_valid);
+        }
+
+        // return the older half when the magazine is full
+        u32& count = magazine->count[class_index];
+        if (count == SLAB_MAGAZINE_CAPACITY) {
+
+            constexpr u32 count_flush = SLAB_MAGAZINE_CAPACITY / 2;
+            void**        objects     = magazine->objects[class_index];
+            slab_class_push_batch(slab, class_index, objects, count_flush);
+
+            (void)memmove(objects, &objects[count_flush], sizeof(void*) * (count - count_flush));
+            count -= count_flush;
+        }
+
+        magazine->objects[class_index][count] = object;
+        ++count;
+        return(is_valid);
+    }
+
+    SLD_API u32
+    slab_allocator_get_object_size(
+        const slab_allocator_t* slab,
+        const void*             object) {
+
+        const slab_header_t* header      = slab_get_header(slab, object);
+        const u32            object_size = (header != NULL) ? header->object_size : 0;
+        return(object_size);
+    }
+
+    SLD_API void
+    slab_magazine_init(
+        slab_magazine_t* magazine) {
+
+        assert(magazine != NULL);
+        for (
+            u32 class_index = 0;
+            class_index < SLAB_CLASS_COUNT;
+            ++class_index) {
+
+            magazine->count[class_index] = 0;
+        }
+    }
+
+    SLD_API void
+    slab_magazine_flush(
+        slab_allocator_t* slab,
+        slab_magazine_t*  magazine) {
+
+        assert(slab_allocator_validate(slab) && magazine != NULL);
+
+        // call before a thread exits so its cached objects aren't lost
+        for (
+            u32 class_index = 0;
+            class_index < SLAB_CLASS_COUNT;
+            ++class_index) {
+
+            slab_class_push_batch(
+                slab,
+                class_index,
+                magazine->objects[class_index],
+                magazine->count[class_index]
+            );
+            magazine->count[class_index] = 0;
+        }
+    }
+};
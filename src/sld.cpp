@@ -5,6 +5,20 @@
 
 #include "sld-hash32.cpp"
 #include "sld-hash128.cpp"
+#include "sld-core-hash-table.cpp"
+#include "sld-string-intern.cpp"
+#include "sld-core-job.cpp"
+#include "sld-core-blob-store.cpp"
+#include "sld-hash-parallel.cpp"
+#include "sld-hash-file.cpp"
 
-#include "sld-win32.cpp"
-#include "sld-cstr.hpp"
+#include "sld-memory-block-allocator.cpp"
+#include "sld-memory-heap.cpp"
+#include "sld-memory-slab-allocator.cpp"
+
+#if defined(_WIN32)
+#   include "sld-win32.cpp"
+#elif defined(__linux__)
+#   include "sld-linux.cpp"
+#endif
+#include "sld-cstr.hpp"
\ No newline at end of file
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "sld-string-intern.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    // the id whose hash matches, the chars aren't compared
+    SLD_INTERNAL u32
+    string_intern_search(
+        const string_intern_t& intern,
+        const hash128_t&       hash) {
+
+        hash_table_value_t value;
+        const bool is_found = hash_table_search_hash(intern.table, hash, value);
+        const u32  id       = is_found ? *(const u32*)value.data : STRING_INTERN_INVALID_ID;
+        return(id);
+    }
+
+    // same as the blob store, a 128 bit collision won't happen but if it does the
+    // string that got there first keeps the hash and the other can't be interned
+    SLD_INTERNAL bool
+    string_intern_is_match(
+        const string_intern_t& intern,
+        const u32              id,
+        const cchar*           chars,
+        const u32              length) {
+
+        const string_intern_entry_t& entry = intern.entries[id];
+
+        bool is_match = true;
+        is_match &= (entry.length == length);
+        is_match &= is_match && (memcmp(entry.chars, chars, length) == 0);
+        return(is_match);
+    }
+
+    //-------------------------------------------------------------------
+    // API
+    //-------------------------------------------------------------------
+
+    SLD_API bool
+    string_intern_init(
+        string_intern_t& intern,
+        arena*           arena,
+        const u32        capacity) {
+
+        bool can_init = true;
+        can_init &= (arena    != NULL);
+        can_init &= (capacity >  1);
+        if (!can_init) return(can_init);
+
+        // size the table so capacity strings fit under its load factor
+        const u64 capacity_table = ((u64)capacity * 100) / HASH_TABLE_DEFAULT_LOAD_PERCENT + 1;
+        if (capacity_table > 0xFFFFFFFF) return(false);
+
+        const u64 size_entries = ((u64)capacity * sizeof(string_intern_entry_t));
+        const u64 size_table   = hash_table_memory_size((u32)capacity_table, sizeof(u32));
+
+        memory_t memory_table;
+        intern.entries     = (string_intern_entry_t*)arena->push_bytes(size_entries, alignof(string_intern_entry_t));
+        memory_table.bytes = arena->push_bytes(size_table, alignof(hash128_t));
+        memory_table.size  = size_table;
+
+        bool is_init = true;
+        is_init &= (intern.entries     != NULL);
+        is_init &= (memory_table.bytes != NULL);
+        is_init &= is_init && hash_table_memory_init(intern.table, memory_table, (u32)capacity_table, sizeof(u32));
+        if (!is_init) return(is_init);
+
+        intern.chars    = arena;
+        intern.count    = 1;
+        intern.capacity = capacity;
+
+        // the empty string can't be hashed, it just owns id 0
+        intern.entries[STRING_INTERN_ID_EMPTY].chars  = "";
+        intern.entries[STRING_INTERN_ID_EMPTY].length = 0;
+        return(true);
+    }
+
+    SLD_API bool
+    string_intern_validate(
+        const string_intern_t& intern) {
+
+        bool is_valid = true;
+        is_valid &= (intern.chars    != NULL);
+        is_valid &= (intern.entries  != NULL);
+        is_valid &= (intern.count    != 0);
+        is_valid &= (intern.count    <= intern.capacity);
+        is_valid &= hash_table_validate(intern.table);
+        return(is_valid);
+    }
+
+    SLD_API u32
+    string_intern_add(
+        string_intern_t& intern,
+        const cchar*     chars,
+        const u32        length) {
+
+        assert(string_intern_validate(intern));
+
+        if (length == 0)   return(STRING_INTERN_ID_EMPTY);
+        if (chars  == NULL) return(STRING_INTERN_INVALID_ID);
+
+        hash_table_key_t key;
+        key.data   = (const byte*)chars;
+        key.length = length;
+
+        const hash128_t hash = hash_table_hash_key(key);
+        const u32       id   = string_intern_search(intern, hash);
+        if (id != STRING_INTERN_INVALID_ID) {
+            const bool is_match = string_intern_is_match(intern, id, chars, length);
+            return(is_match ? id : STRING_INTERN_INVALID_ID);
+        }
+        if (intern.count == intern.capacity) return(STRING_INTERN_INVALID_ID);
+
+        // copy with a terminator so the stored string works as a c string
+        const arena_temp chars_temp = intern.chars->temp_begin();
+        cchar*           chars_copy = (cchar*)intern.chars->push_bytes(length + 1, 1);
+        if (!chars_copy) return(STRING_INTERN_INVALID_ID);
+        memcpy(chars_copy, chars, length);
+        chars_copy[length] = 0;
+
+        // give the chars back if the table won't take the id
+        const u32  id_new      = intern.count;
+        const bool is_inserted = hash_table_insert_hash(intern.table, hash, (const byte*)&id_new);
+        if (!is_inserted) {
+            intern.chars->temp_end(chars_temp);
+            return(STRING_INTERN_INVALID_ID);
+        }
+
+        intern.entries[id_new].chars  = chars_copy;
+        intern.entries[id_new].length = length;
+        ++intern.count;
+        return(id_new);
+    }
+
+    SLD_API u32
+    string_intern_add_cstr(
+        string_intern_t& intern,
+        const cchar*     chars) {
+
+        if (chars == NULL) return(STRING_INTERN_INVALID_ID);
+
+        const u32 length = (u32)strlen(chars);
+        const u32 id     = string_intern_add(intern, chars, length);
+        return(id);
+    }
+
+    SLD_API u32
+    string_intern_find(
+        const string_intern_t& intern,
+        const cchar*           chars,
+        const u32              length) {
+
+        assert(string_intern_validate(intern));
+
+        if (length == 0)    return(STRING_INTERN_ID_EMPTY);
+        if (chars  == NULL) return(STRING_INTERN_INVALID_ID);
+
+        hash_table_key_t key;
+        key.data   = (const byte*)chars;
+        key.length = length;
+
+        const hash128_t hash     = hash_table_hash_key(key);
+        const u32       id       = string_intern_search(intern, hash);
+        const bool      is_match = (id != STRING_INTERN_INVALID_ID) && string_intern_is_match(intern, id, chars, length);
+        return(is_match ? id : STRING_INTERN_INVALID_ID);
+    }
+
+    SLD_API const cchar*
+    string_intern_get(
+        const string_intern_t& intern,
+        const u32              id) {
+
+        const cchar* chars = (id < intern.count)
+            ? intern.entries[id].chars
+            : NULL;
+        return(chars);
+    }
+
+    SLD_API u32
+    string_intern_get_length(
+        const string_intern_t& intern,
+        const u32              id) {
+
+        const u32 length = (id < intern.count)
+            ? intern.entries[id].length
+            : 0;
+        return(length);
+    }
+
+    SLD_API u32
+    string_intern_get_count(
+        const string_intern_t& intern) {
+
+        return(intern.count);
+    }
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <Windows.h>
+#include "sld-win32.hpp"
+
+namespace sld {
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    struct win32_fiber_start_t {
+        os_fiber_function_f function;
+        void*               data;
+    };
+
+    SLD_API_OS_INTERNAL VOID WINAPI
+    win32_fiber_proc(
+        LPVOID param) {
+
+        win32_fiber_start_t* start = (win32_fiber_start_t*)param;
+        start->function(start->data);
+
+        // returning from a fiber ends the thread, that's never what we want
+        panic;
+    }
+
+    //-------------------------------------------------------------------
+    // FIBER
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_FUNC bool
+    win32_fiber_create(
+        os_fiber&           fiber,
+        void*               stack,
+        const u64           stack_size,
+        os_fiber_function_f function,
+        void*               data) {
+
+        // the os allocates the stack with its own guard page, the memory
+        // passed in only holds the start data
+        bool can_create = true;
+        can_create &= (stack      != NULL);
+        can_create &= (function   != NULL);
+        can_create &= (stack_size >= sizeof(win32_fiber_start_t));
+        if (!can_create) return(can_create);
+
+        static_assert(sizeof(win32_fiber_start_t) <= OS_FIBER_START_SIZE, "fiber start data has to fit in OS_FIBER_START_SIZE");
+        win32_fiber_start_t* start = (win32_fiber_start_t*)stack;
+        start->function = function;
+        start->data     = data;
+
+        fiber.os_handle = CreateFiber((SIZE_T)stack_size, win32_fiber_proc, start);
+        return(fiber.os_handle != NULL);
+    }
+
+    SLD_API_OS_FUNC bool
+    win32_fiber_destroy(
+        os_fiber& fiber) {
+
+        if (fiber.os_handle == NULL) return(false);
+
+        DeleteFiber(fiber.os_handle);
+        fiber.os_handle = NULL;
+        return(true);
+    }
+
+    SLD_API_OS_FUNC bool
+    win32_fiber_from_thread(
+        os_fiber& fiber) {
+
+        fiber.os_handle = ConvertThreadToFiber(NULL);
+        return(fiber.os_handle != NULL);
+    }
+
+    SLD_API_OS_FUNC bool
+    win32_fiber_to_thread(
+        os_fiber& fiber) {
+
+        const bool is_thread = (ConvertFiberToThread() != 0);
+        fiber.os_handle = NULL;
+        return(is_thread);
+    }
+
+    SLD_API_OS_FUNC void
+    win32_fiber_switch(
+        os_fiber& fiber_from,
+        os_fiber& fiber_to) {
+
+        // windows tracks the current fiber itself
+        (void)fiber_from;
+        SwitchToFiber(fiber_to.os_handle);
+    }
+};
@@ -252,4 +252,190 @@ namespace sld {
 
         return(true);        
     }
+
+    SLD_API_OS_FUNC u64
+    win32_file_map_get_granularity(
+        void) {
+
+        return(win32_file_get_buffer_granularity());
+    }
+
+    SLD_API_OS_INTERNAL HANDLE
+    win32_file_map_create_protect(
+        const os_file_handle file_hnd,
+        const u64            size,
+        const DWORD          protect) {
+
+        assert(file_hnd != NULL);
+        win32_file_clear_last_error();
+
+        // a size past the end of the file grows it, 0 maps the file as it is
+        static const LPSECURITY_ATTRIBUTES file_map_attributes    = NULL;
+        const DWORD                        file_map_max_size_high = (DWORD)(size >> 32);
+        const DWORD                        file_map_max_size_low  = (DWORD)(size & 0xFFFFFFFF);
+        static const LPCSTR                file_map_name          = NULL;
+        HANDLE file_map_handle = CreateFileMapping(
+            file_hnd,
+            file_map_attributes,
+            protect,
+            file_map_max_size_high,
+            file_map_max_size_low,
+            file_map_name
+        );
+        if (!file_map_handle) {
+            win32_file_set_last_error();
+        }
+        return(file_map_handle);
+    }
+
+    SLD_API_OS_INTERNAL bool
+    win32_file_map_view_access(
+        const os_file_map_handle map_hnd,
+        const u64                offset,
+        const u64                size,
+        const DWORD              access,
+        os_file_mapped_buffer*   view) {
+
+        static const u64 granularity = win32_file_get_buffer_granularity();
+        assert(
+            map_hnd != NULL &&
+            view    != NULL &&
+            size    != 0    &&
+            (offset & (granularity - 1)) == 0
+        );
+        win32_file_clear_last_error();
+
+        const DWORD file_offset_high = (DWORD)(offset >> 32);
+        const DWORD file_offset_low  = (DWORD)(offset & 0xFFFFFFFF);
+        PVOID file_data = MapViewOfFile(
+            map_hnd,
+            access,
+            file_offset_high,
+            file_offset_low,
+            (SIZE_T)size
+        );
+        if (!file_data) {
+            win32_file_set_last_error();
+            return(false);
+        }
+
+        view->map_handle = map_hnd;
+        view->data       = (byte*)file_data;
+        view->size       = size;
+        view->offset     = offset;
+        view->cursor     = 0;
+        return(true);
+    }
+
+    SLD_API_OS_FUNC os_file_map_handle
+    win32_file_map_create(
+        const os_file_handle file_hnd) {
+
+        static const u64 file_map_size = 0;
+        return((os_file_map_handle)win32_file_map_create_protect(file_hnd, file_map_size, PAGE_READONLY));
+    }
+
+    SLD_API_OS_FUNC os_file_map_handle
+    win32_file_map_create_writable(
+        const os_file_handle file_hnd,
+        const u64            size) {
+
+        // never ask for less than the file already is, that fails instead of clamping
+        const u64 file_size     = win32_file_get_size(file_hnd);
+        const u64 file_map_size = (file_size != OS_FILE_SIZE_INVALID && file_size > size) ? file_size : size;
+        return((os_file_map_handle)win32_file_map_create_protect(file_hnd, file_map_size, PAGE_READWRITE));
+    }
+
+    SLD_API_OS_FUNC bool
+    win32_file_map_destroy(
+        const os_file_map_handle map_hnd) {
+
+        assert(map_hnd != NULL);
+        win32_file_clear_last_error();
+
+        const bool is_closed = (bool)CloseHandle(map_hnd);
+        if (!is_closed) {
+            win32_file_set_last_error();
+        }
+        return(is_closed);
+    }
+
+    SLD_API_OS_FUNC bool
+    win32_file_map_view(
+        const os_file_map_handle map_hnd,
+        const u64                offset,
+        const u64                size,
+        os_file_mapped_buffer*   view) {
+
+        return(win32_file_map_view_access(map_hnd, offset, size, FILE_MAP_READ, view));
+    }
+
+    SLD_API_OS_FUNC bool
+    win32_file_map_view_writable(
+        const os_file_map_handle map_hnd,
+        const u64                offset,
+        const u64                size,
+        os_file_mapped_buffer*   view) {
+
+        return(win32_file_map_view_access(map_hnd, offset, size, FILE_MAP_WRITE, view));
+    }
+
+    SLD_API_OS_FUNC bool
+    win32_file_map_unview(
+        os_file_mapped_buffer* view) {
+
+        assert(view != NULL && view->data != NULL);
+        win32_file_clear_last_error();
+
+        const bool is_unmapped = (bool)UnmapViewOfFile(view->data);
+        if (!is_unmapped) {
+            win32_file_set_last_error();
+            return(is_unmapped);
+        }
+
+        view->data   = NULL;
+        view->size   = 0;
+        view->offset = 0;
+        view->cursor = 0;
+        return(is_unmapped);
+    }
+
+    SLD_API_OS_FUNC bool
+    win32_file_map_prefetch(
+        const os_file_mapped_buffer* view) {
+
+        assert(view != NULL && view->data != NULL);
+
+        // only a hint, the view still works if the prefetch doesn't
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = (PVOID)view->data;
+        range.NumberOfBytes  = (SIZE_T)view->size;
+
+        static const ULONG prefetch_flags = 0;
+        const bool is_prefetching = (bool)PrefetchVirtualMemory(
+            GetCurrentProcess(),
+            1,
+            &range,
+            prefetch_flags
+        );
+        return(is_prefetching);
+    }
+
+    SLD_API_OS_FUNC bool
+    win32_file_map_flush(
+        const os_file_mapped_buffer* view) {
+
+        assert(view != NULL && view->data != NULL);
+        win32_file_clear_last_error();
+
+        // the map handle isn't the file, so this starts the writes back without
+        // waiting on the disk. closing the file still writes everything out
+        const bool did_flush_view = (bool)FlushViewOfFile((LPCVOID)view->data, (SIZE_T)view->size);
+        if (!did_flush_view) {
+            win32_file_set_last_error();
+            return(did_flush_view);
+        }
+
+        return(true);
+    }
 };
\ No newline at end of file
@@ -1,9 +1,73 @@
 #pragma once
 
 #include <Windows.h>
-#include "sld-os.hpp"
+#include "sld-win32.hpp"
 
 namespace sld {
+
+    SLD_API_OS_INTERNAL const u64
+    win32_memory_get_page_size(
+        void) {
+
+        static u64 page_size = 0;
+
+        if (page_size == 0) {
+            SYSTEM_INFO sys_info;
+            GetSystemInfo(&sys_info);
+            page_size = sys_info.dwPageSize;
+        }
+
+        assert(page_size != 0);
+        return(page_size);
+    }
+
+    SLD_API_OS_INTERNAL const u64
+    win32_memory_get_granularity(
+        void) {
+
+        static u64 granularity = 0;
+
+        if (granularity == 0) {
+            SYSTEM_INFO sys_info;
+            GetSystemInfo(&sys_info);
+            granularity = sys_info.dwAllocationGranularity;
+        }
+
+        assert(granularity != 0);
+        return(granularity);
+    }
+
+    SLD_API_OS_INTERNAL bool
+    win32_memory_enable_large_pages(
+        void) {
+
+        // NOTE(SAM): large pages need SeLockMemoryPrivilege on the process token,
+        // which only works if the user has been granted "lock pages in memory"
+        static s32 is_enabled = -1;
+        if (is_enabled != -1) return(is_enabled == 1);
+
+        is_enabled = 0;
+
+        HANDLE token = NULL;
+        if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+            return(false);
+        }
+
+        TOKEN_PRIVILEGES privileges = {0};
+        privileges.PrivilegeCount           = 1;
+        privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+        const bool did_lookup = LookupPrivilegeValue(NULL, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid);
+        const bool did_adjust = did_lookup && AdjustTokenPrivileges(token, FALSE, &privileges, 0, NULL, NULL);
+
+        // AdjustTokenPrivileges succeeds even if the privilege wasn't assigned
+        if (did_adjust && GetLastError() == ERROR_SUCCESS) {
+            is_enabled = 1;
+        }
+
+        (void)CloseHandle(token);
+        return(is_enabled == 1);
+    }
     
     SLD_API_OS_FUNC void*
     win32_memory_alloc(
@@ -51,6 +115,27 @@ namespace sld {
         return(memory);
     }
 
+    SLD_API_OS_FUNC void*
+    win32_memory_reserve_large(
+        void*     start,
+        const u64 size) {
+
+        // NOTE(SAM): windows can't reserve large pages without committing them,
+        // so the whole range is committed here and os_memory_commit is a no-op.
+        // returns NULL without the privilege so callers can fall back to os_memory_reserve
+        const u64 large_page_size = win32_memory_get_large_page_size();
+        if (large_page_size == 0 || !win32_memory_enable_large_pages()) return(NULL);
+
+        void* memory = (void*)VirtualAlloc(
+            start,
+            size_align_pow_2(size, large_page_size),
+            MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+            PAGE_READWRITE
+        );
+
+        return(memory);
+    }
+
     SLD_API_OS_FUNC bool
     win32_memory_release(
         void*     start,
@@ -81,6 +166,11 @@ namespace sld {
             PAGE_READWRITE
         );
 
+        // large page ranges are committed up front and can't be committed again
+        if (!memory && win32_memory_is_committed(start)) {
+            memory = start;
+        }
+
         return(memory);
     }
 
@@ -102,10 +192,9 @@ namespace sld {
     win32_memory_align_to_page(
         const u64 size) {
 
-        SLD_API_OS_FUNC SYSTEM_INFO sys_info;
-        GetSystemInfo(&sys_info);
+        static const u64 page_size = win32_memory_get_page_size();
 
-        const u64 size_aligned = size_align_pow_2(size, sys_info.dwPageSize);
+        const u64 size_aligned = size_align_pow_2(size, page_size);
         return(size_aligned);
     }
 
@@ -113,13 +202,33 @@ namespace sld {
     win32_memory_align_to_granularity(
         const u64 size) {
 
-        SLD_API_OS_FUNC SYSTEM_INFO sys_info;
-        GetSystemInfo(&sys_info);
+        static const u64 granularity = win32_memory_get_granularity();
+
+        const u64 size_aligned = size_align_pow_2(size, granularity);
+        return(size_aligned);
+    }
+
+    SLD_API_OS_FUNC u64
+    win32_memory_align_to_large_page(
+        const u64 size) {
+
+        // fall back to regular pages when large pages aren't supported
+        static const u64 large_page_size = win32_memory_get_large_page_size();
+        static const u64 page_size       = win32_memory_get_page_size();
 
-        const u64 size_aligned = size_align_pow_2(size, sys_info.dwAllocationGranularity);
+        const u64 alignment    = (large_page_size != 0) ? large_page_size : page_size;
+        const u64 size_aligned = size_align_pow_2(size, alignment);
         return(size_aligned);
     }
 
+    SLD_API_OS_FUNC u64
+    win32_memory_get_large_page_size(
+        void) {
+
+        static const u64 large_page_size = (u64)GetLargePageMinimum();
+        return(large_page_size);
+    }
+
     SLD_API_OS_FUNC bool
     win32_memory_is_reserved(
         void* start) {
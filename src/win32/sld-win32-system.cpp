@@ -11,7 +11,37 @@ namespace sld {
     win32_system_get_cpu_info(
         os_system_cpu_info& cpu_info) {
 
+        SYSTEM_INFO sys_info;
+        GetSystemInfo(&sys_info);
 
+        cpu_info.parent_core_number  = 0;
+        cpu_info.speed_mhz           = 0;
+        cpu_info.cache_levels        = 0;
+        cpu_info.core_count_logical  = sys_info.dwNumberOfProcessors;
+        cpu_info.core_count_physical = 0;
+
+        // logical cores are the ones this process is allowed to run on, same as linux
+        DWORD_PTR mask_process = 0;
+        DWORD_PTR mask_system  = 0;
+        if (GetProcessAffinityMask(GetCurrentProcess(), &mask_process, &mask_system) && mask_process != 0) {
+            u32 core_count_allowed = 0;
+            for (; mask_process != 0; mask_process &= (mask_process - 1)) ++core_count_allowed;
+            cpu_info.core_count_logical = core_count_allowed;
+        }
+
+        // count the physical cores, each core entry is one or two logical processors
+        SYSTEM_LOGICAL_PROCESSOR_INFORMATION buffer[256];
+        DWORD                                size = sizeof(buffer);
+        if (GetLogicalProcessorInformation(buffer, &size)) {
+
+            const u32 count = size / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+            for (u32 index = 0; index < count; ++index) {
+                cpu_info.core_count_physical += (buffer[index].Relationship == RelationProcessorCore) ? 1 : 0;
+            }
+        }
+        if (cpu_info.core_count_physical == 0) {
+            cpu_info.core_count_physical = cpu_info.core_count_logical;
+        }
     }
 
     SLD_API_OS_FUNC void
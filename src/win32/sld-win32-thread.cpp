@@ -1,8 +1,224 @@
 #pragma once
 
 #include <Windows.h>
-#include "sld-os.hpp"
+#include "sld-win32.hpp"
 
 namespace sld {
 
-};
\ No newline at end of file
+    static_assert(sizeof(SRWLOCK)            <= sizeof(vptr), "SRWLOCK doesn't fit in os_thread_mutex");
+    static_assert(sizeof(CONDITION_VARIABLE) <= sizeof(vptr), "CONDITION_VARIABLE doesn't fit in os_thread_condition");
+
+    //-------------------------------------------------------------------
+    // INTERNAL
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_INTERNAL DWORD WINAPI
+    win32_thread_proc(
+        LPVOID param) {
+
+        os_thread_context* context = (os_thread_context*)param;
+        context->function(*context);
+        return(0);
+    }
+
+    //-------------------------------------------------------------------
+    // THREAD
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_FUNC bool
+    win32_thread_create(
+        os_thread&         thread,
+        os_thread_context& context) {
+
+        if (context.function == NULL) return(false);
+
+        HANDLE handle = CreateThread(
+            NULL,              // default security
+            0,                 // default stack size
+            win32_thread_proc, // entry
+            &context,          // entry param
+            0,                 // run immediately
+            NULL               // don't need the id
+        );
+
+        thread.os_handle = handle;
+        return(handle != NULL);
+    }
+
+    SLD_API_OS_FUNC bool
+    win32_thread_join(
+        os_thread& thread) {
+
+        if (thread.os_handle == NULL) return(false);
+
+        const DWORD result    = WaitForSingleObject((HANDLE)thread.os_handle, INFINITE);
+        const bool  is_joined = (result == WAIT_OBJECT_0);
+        CloseHandle((HANDLE)thread.os_handle);
+
+        thread.os_handle = NULL;
+        return(is_joined);
+    }
+
+    SLD_API_OS_FUNC void
+    win32_thread_get_current(
+        os_thread& thread) {
+
+        // a pseudo handle, it always means whichever thread uses it
+        thread.os_handle = GetCurrentThread();
+    }
+
+    SLD_API_OS_FUNC bool
+    win32_thread_set_name(
+        os_thread&   thread,
+        const cchar* name) {
+
+        if (thread.os_handle == NULL || name == NULL) return(false);
+
+        // cut to the same length linux allows so names match across platforms
+        wchar_t   name_wide[OS_THREAD_NAME_SIZE_MAX];
+        const int length = MultiByteToWideChar(CP_UTF8, 0, name, -1, name_wide, OS_THREAD_NAME_SIZE_MAX);
+        if (length == 0) {
+            const int length_cut = MultiByteToWideChar(CP_UTF8, 0, name, OS_THREAD_NAME_SIZE_MAX - 1, name_wide, OS_THREAD_NAME_SIZE_MAX - 1);
+            name_wide[length_cut] = 0;
+        }
+
+        const bool is_named = SUCCEEDED(SetThreadDescription((HANDLE)thread.os_handle, name_wide));
+        return(is_named);
+    }
+
+    SLD_API_OS_FUNC bool
+    win32_thread_set_affinity(
+        os_thread& thread,
+        const u32  core_index) {
+
+        // only the first processor group
+        if (thread.os_handle == NULL || core_index >= (sizeof(DWORD_PTR) * 8)) return(false);
+
+        // the index counts the processors the process is allowed on, a thread
+        // mask outside the process mask fails
+        DWORD_PTR mask_process = 0;
+        DWORD_PTR mask_system  = 0;
+        if (!GetProcessAffinityMask(GetCurrentProcess(), &mask_process, &mask_system)) return(false);
+
+        DWORD_PTR mask       = 0;
+        u32       core_count = 0;
+        for (
+            u32 bit = 0;
+            bit < (sizeof(DWORD_PTR) * 8) && mask == 0;
+            ++bit) {
+
+            const DWORD_PTR mask_bit = ((DWORD_PTR)1 << bit);
+            if ((mask_process & mask_bit) == 0) continue;
+            if (core_count == core_index) mask = mask_bit;
+            ++core_count;
+        }
+        if (mask == 0) return(false);
+
+        const bool is_pinned = (SetThreadAffinityMask((HANDLE)thread.os_handle, mask) != 0);
+        return(is_pinned);
+    }
+
+    SLD_API_OS_FUNC void
+    win32_thread_yield(
+        void) {
+
+        SwitchToThread();
+    }
+
+    SLD_API_OS_FUNC void
+    win32_thread_sleep(
+        const u32 ms) {
+
+        Sleep(ms);
+    }
+
+    //-------------------------------------------------------------------
+    // MUTEX
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_FUNC bool
+    win32_thread_mutex_create(
+        os_thread_mutex& mutex) {
+
+        InitializeSRWLock((PSRWLOCK)&mutex.os_handle);
+        return(true);
+    }
+
+    SLD_API_OS_FUNC bool
+    win32_thread_mutex_destroy(
+        os_thread_mutex& mutex) {
+
+        // srw locks don't own anything
+        mutex.os_handle = NULL;
+        return(true);
+    }
+
+    SLD_API_OS_FUNC void
+    win32_thread_mutex_lock(
+        os_thread_mutex& mutex) {
+
+        AcquireSRWLockExclusive((PSRWLOCK)&mutex.os_handle);
+    }
+
+    SLD_API_OS_FUNC bool
+    win32_thread_mutex_try_lock(
+        os_thread_mutex& mutex) {
+
+        const bool is_locked = (TryAcquireSRWLockExclusive((PSRWLOCK)&mutex.os_handle) != 0);
+        return(is_locked);
+    }
+
+    SLD_API_OS_FUNC void
+    win32_thread_mutex_unlock(
+        os_thread_mutex& mutex) {
+
+        ReleaseSRWLockExclusive((PSRWLOCK)&mutex.os_handle);
+    }
+
+    //-------------------------------------------------------------------
+    // CONDITION
+    //-------------------------------------------------------------------
+
+    SLD_API_OS_FUNC bool
+    win32_thread_condition_create(
+        os_thread_condition& condition) {
+
+        InitializeConditionVariable((PCONDITION_VARIABLE)&condition.os_handle);
+        return(true);
+    }
+
+    SLD_API_OS_FUNC bool
+    win32_thread_condition_destroy(
+        os_thread_condition& condition) {
+
+        condition.os_handle = NULL;
+        return(true);
+    }
+
+    SLD_API_OS_FUNC void
+    win32_thread_condition_wait(
+        os_thread_condition& condition,
+        os_thread_mutex&     mutex) {
+
+        SleepConditionVariableSRW(
+            (PCONDITION_VARIABLE)&condition.os_handle,
+            (PSRWLOCK)&mutex.os_handle,
+            INFINITE,
+            0
+        );
+    }
+
+    SLD_API_OS_FUNC void
+    win32_thread_condition_signal(
+        os_thread_condition& condition) {
+
+        WakeConditionVariable((PCONDITION_VARIABLE)&condition.os_handle);
+    }
+
+    SLD_API_OS_FUNC void
+    win32_thread_condition_broadcast(
+        os_thread_condition& condition) {
+
+        WakeAllConditionVariable((PCONDITION_VARIABLE)&condition.os_handle);
+    }
+};
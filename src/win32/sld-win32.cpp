@@ -11,6 +11,7 @@
 #include "sld-win32-memory.cpp"
 #include "sld-win32-window.cpp"
 #include "sld-win32-thread.cpp"
+#include "sld-win32-fiber.cpp"
 #include "sld-win32-monitor.cpp"
 
 #if (SLD_OS_WINDOW_GRAPHICS_CONTEXT == os_window_graphics_context_e_opengl)
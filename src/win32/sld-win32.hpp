@@ -30,6 +30,13 @@ namespace sld {
     SLD_API_OS_INTERNAL void             win32_file_clear_last_error       (void);
     SLD_API_OS_INTERNAL const u64        win32_file_get_buffer_granularity (void);
     SLD_API_OS_INTERNAL LPOVERLAPPED     win32_file_get_overlapped         (os_file_async* async);
+    SLD_API_OS_INTERNAL HANDLE           win32_file_map_create_protect     (const os_file_handle file_hnd, const u64 size, const DWORD protect);
+    SLD_API_OS_INTERNAL bool             win32_file_map_view_access        (const os_file_map_handle map_hnd, const u64 offset, const u64 size, const DWORD access, os_file_mapped_buffer* view);
+
+    // memory
+    SLD_API_OS_INTERNAL const u64        win32_memory_get_page_size        (void);
+    SLD_API_OS_INTERNAL const u64        win32_memory_get_granularity      (void);
+    SLD_API_OS_INTERNAL bool             win32_memory_enable_large_pages   (void);
 };
 
 #ifdef     SLD_OS_FILE_SIZE_IO
@@ -68,6 +75,15 @@ namespace sld {
 #define win32_file_mapped_buffer_destroy   os_file_mapped_buffer_destroy
 #define win32_file_mapped_buffer_read      os_file_mapped_buffer_read
 #define win32_file_mapped_buffer_write     os_file_mapped_buffer_write
+#define win32_file_map_get_granularity     os_file_map_get_granularity
+#define win32_file_map_create              os_file_map_create
+#define win32_file_map_create_writable     os_file_map_create_writable
+#define win32_file_map_destroy             os_file_map_destroy
+#define win32_file_map_view                os_file_map_view
+#define win32_file_map_view_writable       os_file_map_view_writable
+#define win32_file_map_unview              os_file_map_unview
+#define win32_file_map_prefetch            os_file_map_prefetch
+#define win32_file_map_flush               os_file_map_flush
 
 #define win32_window_get_last_error        os_window_get_last_error
 #define win32_window_create                os_window_create
@@ -88,13 +104,40 @@ namespace sld {
 #define win32_memory_alloc                os_memory_alloc
 #define win32_memory_free                 os_memory_free
 #define win32_memory_reserve              os_memory_reserve
+#define win32_memory_reserve_large        os_memory_reserve_large
 #define win32_memory_release              os_memory_release
 #define win32_memory_commit               os_memory_commit
 #define win32_memory_decommit             os_memory_decommit
 #define win32_memory_align_to_page        os_memory_align_to_page
 #define win32_memory_align_to_granularity os_memory_align_to_granularity
+#define win32_memory_align_to_large_page  os_memory_align_to_large_page
+#define win32_memory_get_large_page_size  os_memory_get_large_page_size
 #define win32_memory_is_reserved          os_memory_is_reserved
 #define win32_memory_is_committed         os_memory_is_committed
 #define win32_memory_mapping_destroy      os_memory_mapping_destroy
 
+#define win32_thread_create                os_thread_create
+#define win32_thread_join                  os_thread_join
+#define win32_thread_get_current           os_thread_get_current
+#define win32_thread_set_name              os_thread_set_name
+#define win32_thread_set_affinity          os_thread_set_affinity
+#define win32_thread_yield                 os_thread_yield
+#define win32_thread_sleep                 os_thread_sleep
+#define win32_thread_mutex_create          os_thread_mutex_create
+#define win32_thread_mutex_destroy         os_thread_mutex_destroy
+#define win32_thread_mutex_lock            os_thread_mutex_lock
+#define win32_thread_mutex_try_lock        os_thread_mutex_try_lock
+#define win32_thread_mutex_unlock          os_thread_mutex_unlock
+#define win32_thread_condition_create      os_thread_condition_create
+#define win32_thread_condition_destroy     os_thread_condition_destroy
+#define win32_thread_condition_wait        os_thread_condition_wait
+#define win32_thread_condition_signal      os_thread_condition_signal
+#define win32_thread_condition_broadcast   os_thread_condition_broadcast
+
+#define win32_fiber_create                 os_fiber_create
+#define win32_fiber_destroy                os_fiber_destroy
+#define win32_fiber_from_thread            os_fiber_from_thread
+#define win32_fiber_to_thread              os_fiber_to_thread
+#define win32_fiber_switch                 os_fiber_switch
+
 #endif //SLD_WIN32_HPP
\ No newline at end of file
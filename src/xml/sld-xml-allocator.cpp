@@ -11,14 +11,14 @@ namespace sld {
         const u32 size_total, 
         const u32 size_block) {
 
-        block_allocator_reserve_os_memory(&_xml_allocator, size_total, size_block);
+        block_allocator_atomic_reserve_os_memory(&_xml_allocator, size_total, size_block);
     }
 
     SLD_INTERNAL void
     xml_allocator_release_os_memory(
         void) {
 
-        block_allocator_release_os_memory(&_xml_allocator);
+        block_allocator_atomic_release_os_memory(&_xml_allocator);
     }
 
     SLD_INTERNAL xml_doc_t*
@@ -28,8 +28,8 @@ namespace sld {
         constexpr u32 doc_header_size = sizeof(xml_doc_t);
 
         // commit memory        
-        memory_t memory_doc   = block_allocator_commit_memory (&_xml_allocator);
-        memory_t memory_stack = memory_add_offset             (memory_doc, doc_header_size);
+        memory_t memory_doc   = block_allocator_atomic_commit_memory (&_xml_allocator);
+        memory_t memory_stack = memory_add_offset                    (memory_doc, doc_header_size);
 
         // initialize the doc
         xml_doc_t* doc = new (memory_doc.ptr) xml_doc_t();
@@ -42,7 +42,7 @@ namespace sld {
     xml_allocator_commit_pugi(
         const u32 size) {
 
-        xml_pugi_memory_t* pugi = block_allocator_commit(&_xml_allocator);
+        xml_pugi_memory_t* pugi = block_allocator_atomic_commit(&_xml_allocator);
         assert(size <= _xml_allocator.block_size);
         assert(pugi);        
         return(pugi);
@@ -52,13 +52,13 @@ namespace sld {
     xml_allocator_decommit_doc(
         xml_doc_t* xml_doc) {
 
-        block_allocator_decommit(&_xml_allocator, (void*)xml_doc);
+        block_allocator_atomic_decommit(&_xml_allocator, (void*)xml_doc);
     }
 
     SLD_INTERNAL void
     xml_allocator_decommit_pugi(
         xml_pugi_memory_t* pugi) {
         
-        block_allocator_decommit(&_xml_allocator, pugi);
+        block_allocator_atomic_decommit(&_xml_allocator, pugi);
     }
 };
\ No newline at end of file
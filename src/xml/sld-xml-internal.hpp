@@ -10,7 +10,7 @@
 
 namespace sld {
 
-    using xml_block_allocator_t = block_allocator_t;
+    using xml_block_allocator_t = block_allocator_atomic_t;
     using xml_pugi_memory_t     = void;
 
     SLD_INTERNAL void               xml_allocator_reserve_os_memory (const u32 size_total, const u32 size_block);